@@ -0,0 +1,350 @@
+/* Host stub of the QMK action layer: keymap lookup, tap-hold resolution and
+ * the default action for each keycode.
+ *
+ * Tap-hold resolution is a reduced version of quantum/action_tapping.c that
+ * honors the same per-key callbacks as the keymap (get_tapping_term,
+ * get_hold_on_other_key_press, get_permissive_hold) for one pending key.
+ */
+
+#include <string.h>
+
+#include "host.h"
+
+#ifndef TAPPING_TERM
+#define TAPPING_TERM 200
+#endif
+
+// As in QMK, get_tapping_term() is only asked with TAPPING_TERM_PER_KEY.
+#ifdef TAPPING_TERM_PER_KEY
+#define GET_TAPPING_TERM(keycode, record) get_tapping_term(keycode, record)
+#else
+#define GET_TAPPING_TERM(keycode, record) TAPPING_TERM
+#endif
+
+#ifdef TAP_DANCE_ENABLE
+extern tap_dance_action_t tap_dance_actions[];
+#endif
+
+// Keycode and tap count each held key was pressed with, so that the release
+// goes to the same action even if layers changed in between.
+static uint16_t pressed_keycode[MATRIX_ROWS][MATRIX_COLS];
+static uint8_t pressed_tap_count[MATRIX_ROWS][MATRIX_COLS];
+
+// The tap-hold key waiting for a decision, and events queued behind it.
+#define WAITING_BUFFER_SIZE 8
+static bool tapping = false;
+static keyrecord_t tapping_record;
+static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE];
+static uint8_t waiting_count = 0;
+
+static uint16_t last_keycode = KC_NO;
+
+// Debounced matrix state, printed like QMK's matrix_print() when debugging.
+static uint8_t matrix[MATRIX_ROWS];
+
+static void matrix_print(void) {
+  dprintf("\nr/c 012345\n");
+  for (uint8_t row = 0; row < MATRIX_ROWS; ++row) {
+    dprintf("%02X: ", row);
+    for (uint8_t col = 0; col < MATRIX_COLS; ++col) {
+      dprintf("%c", (matrix[row] & (1 << col)) ? '1' : '0');
+    }
+    dprintf("\n");
+  }
+}
+
+__attribute__((weak)) uint16_t keymap_key_to_keycode(uint8_t layer,
+                                                     keypos_t key) {
+  if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+    return pgm_read_word(&keymaps[layer][key.row][key.col]);
+  }
+  return KC_NO;
+}
+
+// Walks down the active layers like QMK's layer_switch_get_layer().
+uint16_t host_keymap_keycode(keypos_t key) {
+  const layer_state_t state = layer_state | default_layer_state;
+  for (int8_t layer = get_highest_layer(state); layer >= 0; --layer) {
+    if (state & ((layer_state_t)1 << layer)) {
+      const uint16_t keycode = keymap_key_to_keycode(layer, key);
+      if (keycode != KC_TRNS) {
+        return keycode;
+      }
+    }
+  }
+  return KC_NO;
+}
+
+static bool is_tap_hold(uint16_t keycode) {
+  return IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode);
+}
+
+static uint8_t mod_config(uint8_t mods) {
+  return (mods & 0x10) ? (mods & 0x0F) << 4 : mods & 0x0F;
+}
+
+static void register_or_unregister(uint16_t keycode, bool pressed) {
+  if (pressed) {
+    register_code16(keycode);
+  } else {
+    unregister_code16(keycode);
+  }
+}
+
+// Default handling of a keycode once every user and feature hook let it pass.
+static void process_action(uint16_t keycode, keyrecord_t* record) {
+  const bool pressed = record->event.pressed;
+
+  if (keycode <= QK_MODS_MAX) {
+    if (keycode == KC_TRNS) {
+      return;
+    }
+    if (pressed) {
+      last_keycode = keycode;
+    }
+    register_or_unregister(keycode, pressed);
+    return;
+  }
+
+  if (IS_QK_MOD_TAP(keycode)) {
+    if (record->tap.count) {
+      register_or_unregister(QK_MOD_TAP_GET_TAP_KEYCODE(keycode), pressed);
+    } else if (pressed) {
+      register_mods(mod_config(QK_MOD_TAP_GET_MODS(keycode)));
+    } else {
+      unregister_mods(mod_config(QK_MOD_TAP_GET_MODS(keycode)));
+    }
+    return;
+  }
+
+  if (IS_QK_LAYER_TAP(keycode)) {
+    if (record->tap.count) {
+      register_or_unregister(QK_LAYER_TAP_GET_TAP_KEYCODE(keycode), pressed);
+    } else if (pressed) {
+      layer_on(QK_LAYER_TAP_GET_LAYER(keycode));
+    } else {
+      layer_off(QK_LAYER_TAP_GET_LAYER(keycode));
+    }
+    return;
+  }
+
+  switch (keycode) {
+    case QK_LAYER_MOD ... QK_LAYER_MOD_MAX:
+      if (pressed) {
+        layer_on(QK_LAYER_MOD_GET_LAYER(keycode));
+        register_mods(mod_config(QK_LAYER_MOD_GET_MODS(keycode)));
+      } else {
+        unregister_mods(mod_config(QK_LAYER_MOD_GET_MODS(keycode)));
+        layer_off(QK_LAYER_MOD_GET_LAYER(keycode));
+      }
+      break;
+
+    case QK_TO ... QK_TO_MAX:
+      if (pressed) {
+        layer_move(QK_TO_GET_LAYER(keycode));
+      }
+      break;
+
+    case QK_MOMENTARY ... QK_MOMENTARY_MAX:
+      if (pressed) {
+        layer_on(QK_MOMENTARY_GET_LAYER(keycode));
+      } else {
+        layer_off(QK_MOMENTARY_GET_LAYER(keycode));
+      }
+      break;
+
+    case QK_TOGGLE_LAYER ... QK_TOGGLE_LAYER_MAX:
+      if (pressed) {
+        layer_invert(QK_TOGGLE_LAYER_GET_LAYER(keycode));
+      }
+      break;
+
+    case QK_ONE_SHOT_MOD ... QK_ONE_SHOT_MOD_MAX:
+      if (pressed) {
+        add_oneshot_mods(mod_config(QK_ONE_SHOT_MOD_GET_MODS(keycode)));
+      }
+      break;
+
+#ifdef TAP_DANCE_ENABLE
+    // Only the single tap action is simulated.
+    case QK_TAP_DANCE ... QK_TAP_DANCE_MAX:
+      register_or_unregister(
+          tap_dance_actions[QK_TAP_DANCE_GET_INDEX(keycode)].kc1, pressed);
+      break;
+#endif  // TAP_DANCE_ENABLE
+
+#ifdef REPEAT_KEY_ENABLE
+    case QK_REPEAT_KEY:
+      register_or_unregister(last_keycode, pressed);
+      break;
+#endif  // REPEAT_KEY_ENABLE
+  }
+}
+
+void host_process_record(keyrecord_t* record) {
+  const uint16_t keycode = record->keycode;
+  ++host_stats.records;
+  if (!process_record_user(keycode, record)) {
+    return;
+  }
+#ifdef LEADER_ENABLE
+  if (!process_leader(keycode, record)) {
+    return;
+  }
+#endif  // LEADER_ENABLE
+  process_action(keycode, record);
+}
+
+static void process_key(keyrecord_t* record);
+
+// Settles the pending tap-hold key and replays everything queued behind it.
+static void tapping_resolve(bool tap) {
+  keyrecord_t queued[WAITING_BUFFER_SIZE];
+  const uint8_t count = waiting_count;
+  memcpy(queued, waiting_buffer, sizeof(queued));
+  waiting_count = 0;
+  tapping = false;
+
+  const keypos_t key = tapping_record.event.key;
+  tapping_record.tap.count = tap ? 1 : 0;
+  pressed_tap_count[key.row][key.col] = tapping_record.tap.count;
+  host_process_record(&tapping_record);
+
+  for (uint8_t i = 0; i < count; ++i) {
+    process_key(&queued[i]);
+  }
+}
+
+static void process_key(keyrecord_t* record) {
+  const keypos_t key = record->event.key;
+
+  if (tapping) {
+    const bool same_key = key.row == tapping_record.event.key.row &&
+                          key.col == tapping_record.event.key.col;
+    if (same_key && !record->event.pressed) {
+      tapping_resolve(true);
+      record->keycode = tapping_record.keycode;
+      record->tap.count = 1;
+      host_process_record(record);
+      return;
+    }
+
+    if (waiting_count < WAITING_BUFFER_SIZE) {
+      waiting_buffer[waiting_count++] = *record;
+    }
+
+    if (record->event.pressed) {
+      if (get_hold_on_other_key_press(tapping_record.keycode,
+                                      &tapping_record)) {
+        tapping_resolve(false);
+      }
+    } else {
+      // A key pressed and released while the tap-hold key is held.
+      for (uint8_t i = 0; i + 1 < waiting_count; ++i) {
+        const keyrecord_t* other = &waiting_buffer[i];
+        if (other->event.pressed && other->event.key.row == key.row &&
+            other->event.key.col == key.col &&
+            get_permissive_hold(tapping_record.keycode, &tapping_record)) {
+          tapping_resolve(false);
+          break;
+        }
+      }
+    }
+    return;
+  }
+
+  // Keycodes are resolved only once the event is no longer waiting, so that
+  // keys queued behind a layer-tap see the layer it turned on.
+  // A keycode set in pre_process_record_user overrides the keymap, like the
+  // keycode field of records does in QMK.
+  if (record->event.pressed) {
+    if (!record->keycode) {
+      record->keycode = host_keymap_keycode(key);
+    }
+    pressed_keycode[key.row][key.col] = record->keycode;
+    pressed_tap_count[key.row][key.col] = 0;
+
+    if (is_tap_hold(record->keycode)) {
+      tapping = true;
+      tapping_record = *record;
+      return;
+    }
+  } else {
+    if (!record->keycode) {
+      record->keycode = pressed_keycode[key.row][key.col];
+    }
+    record->tap.count = pressed_tap_count[key.row][key.col];
+  }
+
+  host_process_record(record);
+}
+
+void action_exec(keyevent_t event) {
+  const keypos_t key = event.key;
+  keyrecord_t record = {.event = event};
+  const uint16_t keycode = event.pressed ? host_keymap_keycode(key)
+                                         : pressed_keycode[key.row][key.col];
+  if (!pre_process_record_user(keycode, &record)) {
+    return;
+  }
+  process_key(&record);
+}
+
+void host_key_event(keypos_t key, bool pressed) {
+  if (pressed) {
+    matrix[key.row] |= 1 << key.col;
+  } else {
+    matrix[key.row] &= ~(1 << key.col);
+  }
+  if (debug_matrix) {
+    matrix_print();
+  }
+
+  ++host_stats.key_events;
+  action_exec((keyevent_t){
+      .key = key,
+      .time = timer_read(),
+      .type = KEY_EVENT,
+      .pressed = pressed,
+  });
+}
+
+void action_tapping_process(keyrecord_t record) { process_key(&record); }
+
+void process_record(keyrecord_t* record) { host_process_record(record); }
+
+void host_action_task(void) {
+  if (tapping && timer_elapsed(tapping_record.event.time) >=
+                     GET_TAPPING_TERM(tapping_record.keycode, &tapping_record)) {
+    tapping_resolve(false);
+  }
+}
+
+__attribute__((weak)) bool pre_process_record_user(uint16_t keycode,
+                                                  keyrecord_t* record) {
+  return true;
+}
+
+__attribute__((weak)) uint16_t get_tapping_term(uint16_t keycode,
+                                               keyrecord_t* record) {
+  return TAPPING_TERM;
+}
+
+__attribute__((weak)) bool get_hold_on_other_key_press(uint16_t keycode,
+                                                      keyrecord_t* record) {
+  return false;
+}
+
+__attribute__((weak)) bool get_permissive_hold(uint16_t keycode,
+                                              keyrecord_t* record) {
+  return false;
+}
+
+void host_action_reset(void) {
+  tapping = false;
+  waiting_count = 0;
+  last_keycode = KC_NO;
+  memset(matrix, 0, sizeof(matrix));
+  memset(pressed_keycode, 0, sizeof(pressed_keycode));
+  memset(pressed_tap_count, 0, sizeof(pressed_tap_count));
+}
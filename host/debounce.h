@@ -0,0 +1,13 @@
+/* Host stub of QMK's debounce.h, the interface a custom debounce
+ * (`DEBOUNCE_TYPE = custom`) implements. The replay driver runs it over the
+ * raw matrix when the keymap links one in.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+void debounce_init(uint8_t num_rows);
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows,
+              bool changed);
+void debounce_free(void);
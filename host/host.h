@@ -0,0 +1,58 @@
+/* Host simulator internals shared between the stub quantum layer and the
+ * replay driver. Nothing in here is visible to keymap code.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+// Simulated millisecond clock, advanced by the driver.
+extern uint32_t host_time;
+
+// Echo debug console output to stderr.
+extern bool host_verbose;
+
+/** A 6KRO keyboard report as it would go out over USB. */
+typedef struct {
+  uint8_t mods;
+  uint8_t keys[6];
+} host_report_t;
+
+/** Counters collected while replaying a trace. */
+typedef struct {
+  uint32_t key_events;   /**< Matrix events fed in by the driver. */
+  uint32_t records;      /**< Records that reached process_record_user. */
+  uint32_t reports;      /**< HID reports sent. */
+  uint32_t console_bytes; /**< Bytes of debug output formatted. */
+  uint32_t led_writes;    /**< rgb_matrix_set_color() calls. */
+  uint32_t eeprom_writes; /**< EEPROM updates that changed it. */
+  uint32_t eeprom_bytes;  /**< EEPROM bytes those updates wrote. */
+} host_stats_t;
+
+extern host_stats_t host_stats;
+
+/** Called for every HID report sent. Set by the driver. */
+extern void (*host_report_sink)(const host_report_t* report);
+
+/** Resets mods, layers, pending reports and tapping state. */
+void host_reset(void);
+
+/** Feeds a physical key event at the current simulated time. */
+void host_key_event(keypos_t key, bool pressed);
+
+/** Runs one matrix scan worth of housekeeping (timeouts, matrix_scan_user). */
+void host_task(void);
+
+/** Resolves the keycode at `key` through the active layer stack. */
+uint16_t host_keymap_keycode(keypos_t key);
+
+// Hooks from the action layer into the stubbed QMK features.
+void host_process_record(keyrecord_t* record);
+bool process_leader(uint16_t keycode, keyrecord_t* record);
+void leader_task(void);
+void caps_word_task(void);
+void host_quantum_reset(void);
+/** Renders one frame of the running effect, like rgb_matrix_task. */
+void host_rgb_matrix_render(void);
+void host_action_reset(void);
+void host_action_task(void);
@@ -0,0 +1,258 @@
+/* Host stub of the QMK keycode space.
+ *
+ * Values follow QMK's quantum_keycodes.h / keycodes.h so that the ranges the
+ * keymap switches over (KC_A ... KC_Z, QK_MOD_TAP ... QK_MOD_TAP_MAX, etc.)
+ * behave exactly as on the board. Only the keycodes used by our keymaps are
+ * listed.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Basic (HID usage) keycodes
+enum host_basic_keycodes {
+  KC_NO = 0x00,
+  KC_TRANSPARENT = 0x01,
+  KC_A = 0x04, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K,
+  KC_L, KC_M, KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W,
+  KC_X, KC_Y, KC_Z,
+  KC_1 = 0x1E, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_0,
+  KC_ENTER = 0x28, KC_ESCAPE, KC_BACKSPACE, KC_TAB, KC_SPACE,
+  KC_MINUS = 0x2D, KC_EQUAL, KC_LEFT_BRACKET, KC_RIGHT_BRACKET, KC_BACKSLASH,
+  KC_NONUS_HASH, KC_SEMICOLON, KC_QUOTE, KC_GRAVE, KC_COMMA, KC_DOT,
+  KC_SLASH, KC_CAPS_LOCK,
+  KC_F1 = 0x3A, KC_F2, KC_F3, KC_F4, KC_F5, KC_F6, KC_F7, KC_F8, KC_F9,
+  KC_F10, KC_F11, KC_F12,
+  KC_INSERT = 0x49, KC_HOME, KC_PAGE_UP, KC_DELETE, KC_END, KC_PAGE_DOWN,
+  KC_RIGHT, KC_LEFT, KC_DOWN, KC_UP,
+  KC_NONUS_BACKSLASH = 0x64,
+  KC_F13 = 0x68, KC_F14, KC_F15, KC_F16, KC_F17, KC_F18, KC_F19, KC_F20,
+  KC_F21, KC_F22, KC_F23, KC_F24,
+  KC_SYSTEM_REQUEST = 0x9A,
+  KC_AUDIO_MUTE = 0xA8, KC_AUDIO_VOL_UP, KC_AUDIO_VOL_DOWN,
+  KC_MEDIA_NEXT_TRACK, KC_MEDIA_PREV_TRACK, KC_MEDIA_STOP,
+  KC_MEDIA_PLAY_PAUSE,
+  KC_BRIGHTNESS_UP = 0xBD, KC_BRIGHTNESS_DOWN,
+  KC_MS_UP = 0xCD, KC_MS_DOWN, KC_MS_LEFT, KC_MS_RIGHT, KC_MS_BTN1,
+  KC_MS_BTN2, KC_MS_BTN3, KC_MS_BTN4, KC_MS_BTN5, KC_MS_BTN6, KC_MS_BTN7,
+  KC_MS_BTN8, KC_MS_WH_UP, KC_MS_WH_DOWN, KC_MS_WH_LEFT, KC_MS_WH_RIGHT,
+  KC_LEFT_CTRL = 0xE0, KC_LEFT_SHIFT, KC_LEFT_ALT, KC_LEFT_GUI,
+  KC_RIGHT_CTRL, KC_RIGHT_SHIFT, KC_RIGHT_ALT, KC_RIGHT_GUI,
+};
+
+// Short aliases
+#define XXXXXXX KC_NO
+#define _______ KC_TRANSPARENT
+#define KC_TRNS KC_TRANSPARENT
+#define KC_ENT KC_ENTER
+#define KC_ESC KC_ESCAPE
+#define KC_BSPC KC_BACKSPACE
+#define KC_SPC KC_SPACE
+#define KC_MINS KC_MINUS
+#define KC_EQL KC_EQUAL
+#define KC_LBRC KC_LEFT_BRACKET
+#define KC_RBRC KC_RIGHT_BRACKET
+#define KC_BSLS KC_BACKSLASH
+#define KC_NUHS KC_NONUS_HASH
+#define KC_SCLN KC_SEMICOLON
+#define KC_QUOT KC_QUOTE
+#define KC_GRV KC_GRAVE
+#define KC_COMM KC_COMMA
+#define KC_SLSH KC_SLASH
+#define KC_CAPS KC_CAPS_LOCK
+#define KC_INS KC_INSERT
+#define KC_DEL KC_DELETE
+#define KC_PGUP KC_PAGE_UP
+#define KC_PGDN KC_PAGE_DOWN
+#define KC_RGHT KC_RIGHT
+#define KC_NUBS KC_NONUS_BACKSLASH
+#define KC_SYRQ KC_SYSTEM_REQUEST
+#define KC_MUTE KC_AUDIO_MUTE
+#define KC_VOLU KC_AUDIO_VOL_UP
+#define KC_VOLD KC_AUDIO_VOL_DOWN
+#define KC_MNXT KC_MEDIA_NEXT_TRACK
+#define KC_MPRV KC_MEDIA_PREV_TRACK
+#define KC_MSTP KC_MEDIA_STOP
+#define KC_MPLY KC_MEDIA_PLAY_PAUSE
+#define KC_BRIU KC_BRIGHTNESS_UP
+#define KC_BRID KC_BRIGHTNESS_DOWN
+#define KC_MS_U KC_MS_UP
+#define KC_MS_D KC_MS_DOWN
+#define KC_MS_L KC_MS_LEFT
+#define KC_MS_R KC_MS_RIGHT
+#define KC_BTN1 KC_MS_BTN1
+#define KC_BTN2 KC_MS_BTN2
+#define KC_BTN3 KC_MS_BTN3
+#define KC_WH_U KC_MS_WH_UP
+#define KC_WH_D KC_MS_WH_DOWN
+#define KC_LCTL KC_LEFT_CTRL
+#define KC_LSFT KC_LEFT_SHIFT
+#define KC_LALT KC_LEFT_ALT
+#define KC_LGUI KC_LEFT_GUI
+#define KC_RCTL KC_RIGHT_CTRL
+#define KC_RSFT KC_RIGHT_SHIFT
+#define KC_RALT KC_RIGHT_ALT
+#define KC_RGUI KC_RIGHT_GUI
+
+// Quantum keycode ranges
+#define QK_BASIC 0x0000
+#define QK_BASIC_MAX 0x00FF
+#define QK_MODS 0x0100
+#define QK_MODS_MAX 0x1FFF
+#define QK_MOD_TAP 0x2000
+#define QK_MOD_TAP_MAX 0x3FFF
+#define QK_LAYER_TAP 0x4000
+#define QK_LAYER_TAP_MAX 0x4FFF
+#define QK_LAYER_MOD 0x5000
+#define QK_LAYER_MOD_MAX 0x51FF
+#define QK_TO 0x5200
+#define QK_TO_MAX 0x521F
+#define QK_MOMENTARY 0x5220
+#define QK_MOMENTARY_MAX 0x523F
+#define QK_DEF_LAYER 0x5240
+#define QK_DEF_LAYER_MAX 0x525F
+#define QK_TOGGLE_LAYER 0x5260
+#define QK_TOGGLE_LAYER_MAX 0x527F
+#define QK_ONE_SHOT_LAYER 0x5280
+#define QK_ONE_SHOT_LAYER_MAX 0x529F
+#define QK_ONE_SHOT_MOD 0x52A0
+#define QK_ONE_SHOT_MOD_MAX 0x52BF
+#define QK_LAYER_TAP_TOGGLE 0x52C0
+#define QK_LAYER_TAP_TOGGLE_MAX 0x52DF
+#define QK_SWAP_HANDS 0x5600
+#define QK_SWAP_HANDS_MAX 0x56FF
+#define QK_TAP_DANCE 0x5700
+#define QK_TAP_DANCE_MAX 0x57FF
+#define QK_LIGHTING 0x7800
+#define QK_LIGHTING_MAX 0x78FF
+#define QK_QUANTUM 0x7C00
+#define QK_QUANTUM_MAX 0x7DFF
+#define QK_KB 0x7E00
+#define QK_KB_MAX 0x7E3F
+#define QK_USER 0x7E40
+#define QK_USER_MAX 0x7FFF
+
+#define SAFE_RANGE QK_USER
+
+// Modifier bits, as used by mod-tap and one-shot mod keycodes
+#define MOD_LCTL 0x01
+#define MOD_LSFT 0x02
+#define MOD_LALT 0x04
+#define MOD_LGUI 0x08
+#define MOD_RCTL 0x11
+#define MOD_RSFT 0x12
+#define MOD_RALT 0x14
+#define MOD_RGUI 0x18
+
+#define QK_LCTL 0x0100
+#define QK_LSFT 0x0200
+#define QK_LALT 0x0400
+#define QK_LGUI 0x0800
+#define QK_RMODS_MIN 0x1000
+#define QK_RCTL 0x1100
+#define QK_RSFT 0x1200
+#define QK_RALT 0x1400
+#define QK_RGUI 0x1800
+
+#define LCTL(kc) (QK_LCTL | (kc))
+#define LSFT(kc) (QK_LSFT | (kc))
+#define LALT(kc) (QK_LALT | (kc))
+#define LGUI(kc) (QK_LGUI | (kc))
+#define RCTL(kc) (QK_RCTL | (kc))
+#define RSFT(kc) (QK_RSFT | (kc))
+#define RALT(kc) (QK_RALT | (kc))
+#define RGUI(kc) (QK_RGUI | (kc))
+#define C(kc) LCTL(kc)
+#define S(kc) LSFT(kc)
+#define A(kc) LALT(kc)
+#define G(kc) LGUI(kc)
+#define ALGR(kc) RALT(kc)
+
+#define QK_MODS_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MODS_GET_BASIC_KEYCODE(kc) ((kc) & 0xFF)
+
+#define MT(mod, kc) (QK_MOD_TAP | (((mod) & 0x1F) << 8) | ((kc) & 0xFF))
+#define LCTL_T(kc) MT(MOD_LCTL, kc)
+#define LSFT_T(kc) MT(MOD_LSFT, kc)
+#define LALT_T(kc) MT(MOD_LALT, kc)
+#define LGUI_T(kc) MT(MOD_LGUI, kc)
+#define RCTL_T(kc) MT(MOD_RCTL, kc)
+#define RSFT_T(kc) MT(MOD_RSFT, kc)
+#define RALT_T(kc) MT(MOD_RALT, kc)
+#define RGUI_T(kc) MT(MOD_RGUI, kc)
+#define QK_MOD_TAP_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MOD_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+
+#define LT(layer, kc) (QK_LAYER_TAP | (((layer) & 0xF) << 8) | ((kc) & 0xFF))
+#define QK_LAYER_TAP_GET_LAYER(kc) (((kc) >> 8) & 0xF)
+#define QK_LAYER_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+
+#define LM(layer, mod) (QK_LAYER_MOD | (((layer) & 0xF) << 5) | ((mod) & 0x1F))
+#define QK_LAYER_MOD_GET_LAYER(kc) (((kc) >> 5) & 0xF)
+#define QK_LAYER_MOD_GET_MODS(kc) ((kc) & 0x1F)
+
+#define TO(layer) (QK_TO | ((layer) & 0x1F))
+#define QK_TO_GET_LAYER(kc) ((kc) & 0x1F)
+#define MO(layer) (QK_MOMENTARY | ((layer) & 0x1F))
+#define QK_MOMENTARY_GET_LAYER(kc) ((kc) & 0x1F)
+#define TG(layer) (QK_TOGGLE_LAYER | ((layer) & 0x1F))
+#define QK_TOGGLE_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+#define OSL(layer) (QK_ONE_SHOT_LAYER | ((layer) & 0x1F))
+#define QK_ONE_SHOT_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+#define OSM(mod) (QK_ONE_SHOT_MOD | ((mod) & 0x1F))
+#define QK_ONE_SHOT_MOD_GET_MODS(kc) ((kc) & 0x1F)
+#define TT(layer) (QK_LAYER_TAP_TOGGLE | ((layer) & 0x1F))
+#define QK_LAYER_TAP_TOGGLE_GET_LAYER(kc) ((kc) & 0x1F)
+#define TD(n) (QK_TAP_DANCE | ((n) & 0xFF))
+#define QK_TAP_DANCE_GET_INDEX(kc) ((kc) & 0xFF)
+
+#define IS_QK_BASIC(kc) ((kc) <= QK_BASIC_MAX)
+#define IS_QK_MODS(kc) ((kc) >= QK_MODS && (kc) <= QK_MODS_MAX)
+#define IS_QK_MOD_TAP(kc) ((kc) >= QK_MOD_TAP && (kc) <= QK_MOD_TAP_MAX)
+#define IS_QK_LAYER_TAP(kc) ((kc) >= QK_LAYER_TAP && (kc) <= QK_LAYER_TAP_MAX)
+#define IS_QK_TAP_DANCE(kc) ((kc) >= QK_TAP_DANCE && (kc) <= QK_TAP_DANCE_MAX)
+#define IS_BASIC_KEYCODE(kc) ((kc) >= KC_A && (kc) <= 0xA4)  // To KC_EXSEL
+#define IS_MODIFIER_KEYCODE(kc) ((kc) >= KC_LEFT_CTRL && (kc) <= KC_RIGHT_GUI)
+
+// US shifted symbols used by the keymaps
+#define KC_EXLM LSFT(KC_1)
+#define KC_HASH LSFT(KC_3)
+#define KC_PERC LSFT(KC_5)
+#define KC_UNDS LSFT(KC_MINS)
+#define KC_TILD LSFT(KC_GRV)
+
+// Quantum keycodes
+enum host_quantum_keycodes {
+  QK_BOOT = QK_QUANTUM,
+  QK_DYNAMIC_MACRO_RECORD_START_1 = 0x7C53,
+  QK_DYNAMIC_MACRO_RECORD_START_2,
+  QK_DYNAMIC_MACRO_RECORD_STOP,
+  QK_DYNAMIC_MACRO_PLAY_1,
+  QK_DYNAMIC_MACRO_PLAY_2,
+  QK_LEADER,
+  QK_CAPS_WORD_TOGGLE = 0x7C73,
+  QK_REPEAT_KEY = 0x7C79,
+  QK_ALT_REPEAT_KEY,
+
+  QK_BACKLIGHT_ON = QK_LIGHTING,
+  QK_BACKLIGHT_OFF,
+  QK_BACKLIGHT_TOGGLE,
+  QK_BACKLIGHT_DOWN,
+  QK_BACKLIGHT_UP,
+};
+
+#define DM_REC1 QK_DYNAMIC_MACRO_RECORD_START_1
+#define DM_REC2 QK_DYNAMIC_MACRO_RECORD_START_2
+#define DM_RSTP QK_DYNAMIC_MACRO_RECORD_STOP
+#define DM_PLY1 QK_DYNAMIC_MACRO_PLAY_1
+#define DM_PLY2 QK_DYNAMIC_MACRO_PLAY_2
+#define QK_LEAD QK_LEADER
+#define CW_TOGG QK_CAPS_WORD_TOGGLE
+#define QK_REP QK_REPEAT_KEY
+#define QK_AREP QK_ALT_REPEAT_KEY
+#define BL_ON QK_BACKLIGHT_ON
+#define BL_OFF QK_BACKLIGHT_OFF
+#define BL_TOGG QK_BACKLIGHT_TOGGLE
+#define BL_DOWN QK_BACKLIGHT_DOWN
+#define BL_UP QK_BACKLIGHT_UP
@@ -0,0 +1,55 @@
+/* Host stub of quantum/keymap_extras/keymap_swedish.h. */
+
+#pragma once
+
+#include "keycodes.h"
+
+// Row 1
+#define SE_SECT KC_GRV
+#define SE_PLUS KC_MINS
+#define SE_ACUT KC_EQL
+// Row 2
+#define SE_ARNG KC_LBRC
+#define SE_DIAE KC_RBRC
+// Row 3
+#define SE_ODIA KC_SCLN
+#define SE_ADIA KC_QUOT
+#define SE_QUOT KC_NUHS
+// Row 4
+#define SE_LABK KC_NUBS
+#define SE_MINS KC_SLSH
+
+// Shifted symbols
+#define SE_HALF S(SE_SECT)
+#define SE_EXLM S(KC_1)
+#define SE_DQUO S(KC_2)
+#define SE_HASH S(KC_3)
+#define SE_CURR S(KC_4)
+#define SE_PERC S(KC_5)
+#define SE_AMPR S(KC_6)
+#define SE_SLSH S(KC_7)
+#define SE_LPRN S(KC_8)
+#define SE_RPRN S(KC_9)
+#define SE_EQL S(KC_0)
+#define SE_QUES S(SE_PLUS)
+#define SE_GRV S(SE_ACUT)
+#define SE_CIRC S(SE_DIAE)
+#define SE_ASTR S(SE_QUOT)
+#define SE_RABK S(SE_LABK)
+#define SE_SCLN S(KC_COMM)
+#define SE_COLN S(KC_DOT)
+#define SE_UNDS S(SE_MINS)
+
+// AltGr symbols
+#define SE_AT ALGR(KC_2)
+#define SE_PND ALGR(KC_3)
+#define SE_DLR ALGR(KC_4)
+#define SE_EURO ALGR(KC_5)
+#define SE_LCBR ALGR(KC_7)
+#define SE_LBRC ALGR(KC_8)
+#define SE_RBRC ALGR(KC_9)
+#define SE_RCBR ALGR(KC_0)
+#define SE_BSLS ALGR(SE_PLUS)
+#define SE_TILD ALGR(SE_DIAE)
+#define SE_PIPE ALGR(SE_LABK)
+#define SE_MU ALGR(KC_M)
@@ -0,0 +1,435 @@
+/* Replays timestamped key event traces through the keymap at full speed.
+ *
+ * Usage: host [options] [trace ...]
+ *
+ *   -r         Print every HID report sent (for diffing between builds).
+ *   -v         Echo debug console output to stderr.
+ *   -n COUNT   Replay the traces COUNT times (default 1).
+ *   -t TEXT    Synthesize a trace that types TEXT on the base layer.
+ *   -i MS      Interval between synthesized key presses (default 120).
+ *   -d         Dump the loaded trace in trace format and exit.
+ *   -p         Print the pipeline profile at the end (needs
+ *              PIPELINE_PROFILE_ENABLE = yes).
+ *   -l LAYERS  Instead of replaying traces, time keymap lookups of every key
+ *              with layers 0 to LAYERS - 1 on, COUNT * 10000 times, then
+ *              again with the top layer toggled between rounds. Lookups walk
+ *              the layers like QMK's event path, and also go through the
+ *              keycode cache if the keymap enables it.
+ *
+ * Trace format, one event per line, '#' starts a comment:
+ *
+ *   <time ms> <row> <col> <d|u>
+ *
+ * where row (0-3) and col (0-11) address the visual LAYOUT_planck_grid grid.
+ * Between events the simulated clock advances one matrix scan per
+ * millisecond, running the same housekeeping as the firmware main loop.
+ * Events are raw matrix changes: if the keymap brings its own debounce
+ * (`DEBOUNCE_TYPE = custom`), they go through it like on the board, so traces
+ * can contain switch chatter. Otherwise they are fed in as they are.
+ */
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "debounce.h"
+#include "host.h"
+
+#define RGB_MATRIX_FRAME_INTERVAL 16
+#define SETTLE_TIME 1000
+
+// Linked in when the keymap enables the pipeline profile.
+extern void pipeline_profile_print(void) __attribute__((weak));
+// Linked in when the keymap has a custom debounce.
+extern bool debounce(matrix_row_t raw[], matrix_row_t cooked[],
+                     uint8_t num_rows, bool changed) __attribute__((weak));
+extern void debounce_init(uint8_t num_rows) __attribute__((weak));
+// Linked in when the keymap enables the keycode cache.
+extern uint16_t keycode_cache_get(keypos_t key) __attribute__((weak));
+
+typedef struct {
+  uint32_t time;
+  uint8_t row;
+  uint8_t col;
+  bool pressed;
+} trace_event_t;
+
+static trace_event_t* trace = NULL;
+static size_t trace_size = 0;
+static size_t trace_capacity = 0;
+
+static bool print_reports = false;
+static bool print_profile = false;
+static uint32_t last_rgb_frame = 0;
+
+// Matrix before and after the custom debounce.
+static matrix_row_t raw_matrix[MATRIX_ROWS];
+static matrix_row_t debounced_matrix[MATRIX_ROWS];
+static bool raw_matrix_changed = false;
+
+// Per-event processing cost in nanoseconds.
+static uint64_t cost_total = 0;
+static uint64_t cost_min = UINT64_MAX;
+static uint64_t cost_max = 0;
+
+static void trace_append(uint32_t time, uint8_t row, uint8_t col,
+                         bool pressed) {
+  if (trace_size == trace_capacity) {
+    trace_capacity = trace_capacity ? trace_capacity * 2 : 256;
+    trace = realloc(trace, trace_capacity * sizeof(trace_event_t));
+    if (!trace) {
+      perror("realloc");
+      exit(1);
+    }
+  }
+  trace[trace_size++] = (trace_event_t){time, row, col, pressed};
+}
+
+static bool load_trace(const char* path) {
+  FILE* file = fopen(path, "r");
+  if (!file) {
+    perror(path);
+    return false;
+  }
+
+  // Traces are concatenated, each one starting after the previous ends.
+  const uint32_t offset = trace_size ? trace[trace_size - 1].time + 1 : 0;
+  char line[128];
+  int line_number = 0;
+  while (fgets(line, sizeof(line), file)) {
+    ++line_number;
+    char* comment = strchr(line, '#');
+    if (comment) {
+      *comment = '\0';
+    }
+    unsigned time, row, col;
+    char action;
+    const int fields = sscanf(line, "%u %u %u %c", &time, &row, &col, &action);
+    if (fields <= 0) {
+      continue;
+    }
+    if (fields != 4 || row > 3 || col > 11 || (action != 'd' && action != 'u')) {
+      fprintf(stderr, "%s:%d: malformed event\n", path, line_number);
+      fclose(file);
+      return false;
+    }
+    trace_append(offset + time, row, col, action == 'd');
+  }
+  fclose(file);
+  return true;
+}
+
+// Finds the grid position of a keycode on the base layer, looking through
+// mod-taps and layer-taps to their tap keycode.
+static bool find_key(uint16_t keycode, uint8_t* row, uint8_t* col) {
+  for (uint8_t r = 0; r < 4; ++r) {
+    for (uint8_t c = 0; c < 12; ++c) {
+      uint16_t kc = keymaps[0][c < 6 ? r : r + 4][c % 6];
+      if (IS_QK_MOD_TAP(kc) || IS_QK_LAYER_TAP(kc)) {
+        kc &= 0xFF;
+      }
+      if (kc == keycode) {
+        *row = r;
+        *col = c;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static bool synthesize_trace(const char* text, uint32_t interval) {
+  uint32_t time = trace_size ? trace[trace_size - 1].time + interval : 0;
+  for (const char* c = text; *c; ++c) {
+    uint16_t keycode = KC_NO;
+    const char ch = tolower((unsigned char)*c);
+    if (ch >= 'a' && ch <= 'z') {
+      keycode = KC_A + (ch - 'a');
+    } else if (ch == ' ') {
+      keycode = KC_SPC;
+    } else if (ch == '.') {
+      keycode = KC_DOT;
+    } else if (ch == ',') {
+      keycode = KC_COMM;
+    }
+    uint8_t row, col;
+    if (keycode == KC_NO || !find_key(keycode, &row, &col)) {
+      fprintf(stderr, "cannot synthesize '%c' on the base layer\n", *c);
+      return false;
+    }
+    // Release before the next press so that mod-taps settle as taps.
+    trace_append(time, row, col, true);
+    trace_append(time + interval / 2, row, col, false);
+    time += interval;
+  }
+  return true;
+}
+
+static void print_report(const host_report_t* report) {
+  printf("%8u mods=%02x keys=%02x %02x %02x %02x %02x %02x\n", host_time,
+         report->mods, report->keys[0], report->keys[1], report->keys[2],
+         report->keys[3], report->keys[4], report->keys[5]);
+}
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+// Feeds a key event into the keymap, accounting for its processing cost.
+static void feed_key_event(keypos_t key, bool pressed) {
+  const uint64_t begin = now_ns();
+  host_key_event(key, pressed);
+  const uint64_t cost = now_ns() - begin;
+
+  cost_total += cost;
+  if (cost < cost_min) {
+    cost_min = cost;
+  }
+  if (cost > cost_max) {
+    cost_max = cost;
+  }
+}
+
+// Runs the custom debounce over the raw matrix and feeds in the changes it
+// lets through, like matrix_scan() on the board.
+static void debounce_scan(void) {
+  matrix_row_t previous[MATRIX_ROWS];
+  memcpy(previous, debounced_matrix, sizeof(previous));
+  const bool changed = raw_matrix_changed;
+  raw_matrix_changed = false;
+  if (!debounce(raw_matrix, debounced_matrix, MATRIX_ROWS, changed)) {
+    return;
+  }
+  for (uint8_t row = 0; row < MATRIX_ROWS; ++row) {
+    const matrix_row_t delta = previous[row] ^ debounced_matrix[row];
+    for (uint8_t col = 0; col < MATRIX_COLS; ++col) {
+      if (delta & (1 << col)) {
+        feed_key_event((keypos_t){.row = row, .col = col},
+                       debounced_matrix[row] & (1 << col));
+      }
+    }
+  }
+}
+
+void host_task(void) {
+  if (debounce) {
+    debounce_scan();
+  }
+  host_action_task();
+#ifdef LEADER_ENABLE
+  leader_task();
+#endif  // LEADER_ENABLE
+#ifdef CAPS_WORD_ENABLE
+  caps_word_task();
+#endif  // CAPS_WORD_ENABLE
+  matrix_scan_user();
+  housekeeping_task_user();
+  // rgb_matrix_task renders the effect and then calls the indicators, only
+  // while an effect is running
+  if (host_time - last_rgb_frame >= RGB_MATRIX_FRAME_INTERVAL) {
+    last_rgb_frame = host_time;
+    if (rgb_matrix_get_mode() != RGB_MATRIX_NONE) {
+      host_rgb_matrix_render();
+      rgb_matrix_indicators_user();
+    }
+  }
+}
+
+void host_reset(void) {
+  host_quantum_reset();
+  host_action_reset();
+  memset(raw_matrix, 0, sizeof(raw_matrix));
+  memset(debounced_matrix, 0, sizeof(debounced_matrix));
+  raw_matrix_changed = false;
+  if (debounce_init) {
+    debounce_init(MATRIX_ROWS);
+  }
+}
+
+static void advance_to(uint32_t time) {
+  while (host_time < time) {
+    ++host_time;
+    host_task();
+  }
+}
+
+static void replay(void) {
+  const uint32_t start = host_time;
+  for (size_t i = 0; i < trace_size; ++i) {
+    const trace_event_t* event = &trace[i];
+    advance_to(start + event->time);
+
+    const keypos_t key = {
+        .row = event->col < 6 ? event->row : event->row + 4,
+        .col = event->col % 6,
+    };
+    if (debounce) {
+      if (event->pressed) {
+        raw_matrix[key.row] |= 1 << key.col;
+      } else {
+        raw_matrix[key.row] &= ~(1 << key.col);
+      }
+      raw_matrix_changed = true;
+      debounce_scan();
+    } else {
+      feed_key_event(key, event->pressed);
+    }
+  }
+  advance_to(host_time + SETTLE_TIME);
+}
+
+// Resolves every key with `lookup` `rounds` times, toggling the top layer
+// between rounds if `toggle`, and returns the time it took.
+static uint64_t time_lookups(uint16_t (*lookup)(keypos_t key), unsigned rounds,
+                             uint8_t top_layer, bool toggle) {
+  volatile uint16_t sink = 0;
+  const uint64_t begin = now_ns();
+  for (unsigned i = 0; i < rounds; ++i) {
+    if (toggle) {
+      layer_invert(top_layer);
+    }
+    keypos_t key;
+    for (key.row = 0; key.row < MATRIX_ROWS; ++key.row) {
+      for (key.col = 0; key.col < MATRIX_COLS; ++key.col) {
+        sink += lookup(key);
+      }
+    }
+  }
+  (void)sink;
+  return now_ns() - begin;
+}
+
+static void print_lookups(const char* name, uint16_t (*lookup)(keypos_t key),
+                          unsigned rounds, uint8_t top_layer) {
+  const double lookups = (double)rounds * MATRIX_ROWS * MATRIX_COLS;
+  const uint64_t steady = time_lookups(lookup, rounds, top_layer, false);
+  const uint64_t toggled = time_lookups(lookup, rounds, top_layer, true);
+  fprintf(stderr, "%-15s %.0f/s  %.2f ns, toggling %.0f/s  %.2f ns\n", name,
+          lookups * 1e9 / steady, steady / lookups, lookups * 1e9 / toggled,
+          toggled / lookups);
+}
+
+static void bench_lookups(uint8_t layers, unsigned repeat) {
+  host_reset();
+  keyboard_post_init_user();
+  for (uint8_t layer = 1; layer < layers; ++layer) {
+    layer_on(layer);
+  }
+  const unsigned rounds = repeat * 10000;
+  fprintf(stderr, "layers          %u\n", layers);
+  fprintf(stderr, "lookups         %.0f\n",
+          (double)rounds * MATRIX_ROWS * MATRIX_COLS);
+  print_lookups("layer walk", host_keymap_keycode, rounds, layers - 1);
+  if (keycode_cache_get) {
+    print_lookups("keycode cache", keycode_cache_get, rounds, layers - 1);
+  }
+}
+
+int main(int argc, char** argv) {
+  unsigned repeat = 1;
+  unsigned interval = 120;
+  bool dump = false;
+  uint8_t bench_layers = 0;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "rvn:t:i:dpl:")) != -1) {
+    switch (opt) {
+      case 'r':
+        print_reports = true;
+        break;
+      case 'v':
+        host_verbose = true;
+        break;
+      case 'n':
+        repeat = strtoul(optarg, NULL, 10);
+        break;
+      case 'i':
+        interval = strtoul(optarg, NULL, 10);
+        break;
+      case 't':
+        if (!synthesize_trace(optarg, interval)) {
+          return 1;
+        }
+        break;
+      case 'd':
+        dump = true;
+        break;
+      case 'p':
+        print_profile = true;
+        break;
+      case 'l':
+        bench_layers = strtoul(optarg, NULL, 10);
+        break;
+      default:
+        fprintf(stderr,
+                "usage: %s [-r] [-v] [-d] [-p] [-n count] [-i ms] [-t text] "
+                "[-l layers] [trace ...]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+  if (bench_layers) {
+    bench_lookups(bench_layers, repeat);
+    return 0;
+  }
+  for (int i = optind; i < argc; ++i) {
+    if (!load_trace(argv[i])) {
+      return 1;
+    }
+  }
+  if (trace_size == 0) {
+    fprintf(stderr, "no events to replay\n");
+    return 1;
+  }
+
+  if (dump) {
+    for (size_t i = 0; i < trace_size; ++i) {
+      printf("%u %u %u %c\n", trace[i].time, trace[i].row, trace[i].col,
+             trace[i].pressed ? 'd' : 'u');
+    }
+    return 0;
+  }
+
+  if (print_reports) {
+    host_report_sink = print_report;
+  }
+
+  host_reset();
+  keyboard_post_init_user();
+
+  const uint64_t begin = now_ns();
+  for (unsigned i = 0; i < repeat; ++i) {
+    replay();
+  }
+  const uint64_t wall = now_ns() - begin;
+
+  const uint32_t events = host_stats.key_events;
+  fprintf(stderr, "events          %u\n", events);
+  fprintf(stderr, "records         %u\n", host_stats.records);
+  fprintf(stderr, "reports         %u\n", host_stats.reports);
+  fprintf(stderr, "console bytes   %u\n", host_stats.console_bytes);
+  fprintf(stderr, "led writes      %u\n", host_stats.led_writes);
+  fprintf(stderr, "eeprom writes   %u\n", host_stats.eeprom_writes);
+  fprintf(stderr, "eeprom bytes    %u\n", host_stats.eeprom_bytes);
+  fprintf(stderr, "simulated time  %u ms\n", host_time);
+  fprintf(stderr, "wall time       %.3f ms\n", wall / 1e6);
+  fprintf(stderr, "events/s        %.0f\n",
+          cost_total ? events * 1e9 / cost_total : 0.0);
+  fprintf(stderr, "ns/event        min %llu  avg %.1f  max %llu\n",
+          (unsigned long long)cost_min, (double)cost_total / events,
+          (unsigned long long)cost_max);
+
+  if (print_profile) {
+    if (pipeline_profile_print) {
+      fputc('\n', stderr);
+      pipeline_profile_print();
+    } else {
+      fprintf(stderr, "pipeline profile is not enabled\n");
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,13 @@
+/* Host stub of qmk-vim's public header. Vim mode is not simulated: keys pass
+ * straight through, but toggling is tracked.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+bool vim_mode_enabled(void);
+void enable_vim_mode(void);
+void disable_vim_mode(void);
+void toggle_vim_mode(void);
+bool process_vim_mode(uint16_t keycode, keyrecord_t *record);
@@ -0,0 +1,650 @@
+/* Host stub of the QMK quantum layer: timer, mods, HID reports, layers, caps
+ * word, leader and dynamic macros.
+ *
+ * Behavior follows QMK closely enough that the same keymap produces the same
+ * sequence of reports, but hardware and USB are replaced by plain globals.
+ */
+
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+
+#include "host.h"
+
+uint32_t host_time = 0;
+bool host_verbose = false;
+host_stats_t host_stats = {0};
+void (*host_report_sink)(const host_report_t* report) = NULL;
+
+bool debug_enable = false;
+bool debug_matrix = false;
+bool debug_keyboard = false;
+
+layer_state_t layer_state = 0;
+layer_state_t default_layer_state = 1;
+
+static uint8_t real_mods = 0;
+static uint8_t weak_mods = 0;
+static uint8_t oneshot_mods = 0;
+static uint8_t report_keys[6] = {0};
+
+// Timer
+
+uint16_t timer_read(void) { return (uint16_t)host_time; }
+uint32_t timer_read32(void) { return host_time; }
+uint16_t timer_elapsed(uint16_t last) { return timer_read() - last; }
+uint32_t timer_elapsed32(uint32_t last) { return timer_read32() - last; }
+
+// Stand-in for the Cortex-M DWT cycle counter used by the pipeline profile:
+// nanoseconds of host time.
+uint32_t pipeline_profile_read_cycles(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec);
+}
+
+// Console
+
+int host_console_printf(const char* fmt, ...) {
+  char buffer[256];
+  va_list args;
+  va_start(args, fmt);
+  const int len = vsnprintf(buffer, sizeof(buffer), fmt, args);
+  va_end(args);
+  if (len > 0) {
+    host_stats.console_bytes += len;
+    if (host_verbose) {
+      fputs(buffer, stderr);
+    }
+  }
+  return len;
+}
+
+int8_t sendchar(uint8_t c) {
+  ++host_stats.console_bytes;
+  if (host_verbose) {
+    fputc(c, stderr);
+  }
+  return 0;
+}
+
+int host_console_uprintf(const char* fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  const int len = vfprintf(stderr, fmt, args);
+  va_end(args);
+  return len;
+}
+
+// Mods
+
+uint8_t get_mods(void) { return real_mods; }
+void add_mods(uint8_t mods) { real_mods |= mods; }
+void del_mods(uint8_t mods) { real_mods &= ~mods; }
+void set_mods(uint8_t mods) { real_mods = mods; }
+void clear_mods(void) { real_mods = 0; }
+
+void register_mods(uint8_t mods) {
+  if (mods) {
+    add_mods(mods);
+    send_keyboard_report();
+  }
+}
+
+void unregister_mods(uint8_t mods) {
+  if (mods) {
+    del_mods(mods);
+    send_keyboard_report();
+  }
+}
+
+uint8_t get_weak_mods(void) { return weak_mods; }
+void add_weak_mods(uint8_t mods) { weak_mods |= mods; }
+void del_weak_mods(uint8_t mods) { weak_mods &= ~mods; }
+void clear_weak_mods(void) { weak_mods = 0; }
+
+uint8_t get_oneshot_mods(void) { return oneshot_mods; }
+void add_oneshot_mods(uint8_t mods) { oneshot_mods |= mods; }
+void set_oneshot_mods(uint8_t mods) { oneshot_mods = mods; }
+void clear_oneshot_mods(void) { oneshot_mods = 0; }
+uint8_t get_oneshot_layer(void) { return 0; }
+void reset_oneshot_layer(void) {}
+
+// Converts the 5-bit mod encoding of QK_MODS / MT / OSM to 8-bit mod bits.
+static uint8_t mod_config(uint8_t mods) {
+  return (mods & 0x10) ? (mods & 0x0F) << 4 : mods & 0x0F;
+}
+
+// Reports
+
+// The "USB" end of the host driver, hands reports to the replay driver.
+static void host_send_keyboard(report_keyboard_t* keyboard_report) {
+  host_report_t report = {.mods = keyboard_report->mods};
+  memcpy(report.keys, keyboard_report->keys, sizeof(report.keys));
+  ++host_stats.reports;
+  if (debug_keyboard) {
+    dprintf("keyboard_report: %02X | %02X %02X %02X %02X %02X %02X\n",
+            report.mods, report.keys[0], report.keys[1], report.keys[2],
+            report.keys[3], report.keys[4], report.keys[5]);
+  }
+  if (host_report_sink) {
+    host_report_sink(&report);
+  }
+}
+
+static host_driver_t host_driver = {.send_keyboard = host_send_keyboard};
+static host_driver_t* driver = &host_driver;
+
+host_driver_t* host_get_driver(void) { return driver; }
+void host_set_driver(host_driver_t* new_driver) { driver = new_driver; }
+
+void send_keyboard_report(void) {
+  report_keyboard_t report = {.mods = real_mods | weak_mods | oneshot_mods};
+  memcpy(report.keys, report_keys, sizeof(report.keys));
+  driver->send_keyboard(&report);
+}
+
+void add_key(uint8_t kc) {
+  for (int i = 0; i < 6; ++i) {
+    if (report_keys[i] == kc) {
+      return;
+    }
+  }
+  for (int i = 0; i < 6; ++i) {
+    if (report_keys[i] == KC_NO) {
+      report_keys[i] = kc;
+      return;
+    }
+  }
+}
+
+void del_key(uint8_t kc) {
+  for (int i = 0; i < 6; ++i) {
+    if (report_keys[i] == kc) {
+      report_keys[i] = KC_NO;
+    }
+  }
+}
+
+void register_code(uint8_t kc) {
+  if (kc == KC_NO) {
+    return;
+  }
+  if (IS_MODIFIER_KEYCODE(kc)) {
+    add_mods(MOD_BIT(kc));
+    send_keyboard_report();
+    return;
+  }
+  add_key(kc);
+  send_keyboard_report();
+  // One-shot mods apply to exactly one key.
+  if (oneshot_mods) {
+    clear_oneshot_mods();
+  }
+}
+
+void unregister_code(uint8_t kc) {
+  if (kc == KC_NO) {
+    return;
+  }
+  if (IS_MODIFIER_KEYCODE(kc)) {
+    del_mods(MOD_BIT(kc));
+  } else {
+    del_key(kc);
+  }
+  send_keyboard_report();
+}
+
+void tap_code(uint8_t kc) {
+  register_code(kc);
+  unregister_code(kc);
+}
+
+void register_code16(uint16_t kc) {
+  if (IS_QK_MODS(kc)) {
+    add_weak_mods(mod_config(QK_MODS_GET_MODS(kc)));
+  }
+  register_code(kc & 0xFF);
+}
+
+void unregister_code16(uint16_t kc) {
+  unregister_code(kc & 0xFF);
+  if (IS_QK_MODS(kc)) {
+    del_weak_mods(mod_config(QK_MODS_GET_MODS(kc)));
+    send_keyboard_report();
+  }
+}
+
+void tap_code16(uint16_t kc) {
+  register_code16(kc);
+  unregister_code16(kc);
+}
+
+// US ASCII tables; keymaps override them by including a sendstring_*.h header.
+// clang-format off
+__attribute__((weak)) const uint8_t ascii_to_shift_lut[16] = {
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // NUL SOH STX ETX EOT ENQ ACK BEL
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // BS  TAB LF  VT  FF  CR  SO  SI
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // DLE DC1 DC2 DC3 DC4 NAK SYN ETB
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // CAN EM  SUB ESC FS  GS  RS  US
+    KCLUT_ENTRY(0, 1, 1, 1, 1, 1, 1, 0),  //     !   "   #   $   %   &   '
+    KCLUT_ENTRY(1, 1, 1, 1, 0, 0, 0, 0),  // (   )   *   +   ,   -   .   /
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // 0   1   2   3   4   5   6   7
+    KCLUT_ENTRY(0, 0, 1, 0, 1, 0, 1, 1),  // 8   9   :   ;   <   =   >   ?
+    KCLUT_ENTRY(1, 1, 1, 1, 1, 1, 1, 1),  // @   A   B   C   D   E   F   G
+    KCLUT_ENTRY(1, 1, 1, 1, 1, 1, 1, 1),  // H   I   J   K   L   M   N   O
+    KCLUT_ENTRY(1, 1, 1, 1, 1, 1, 1, 1),  // P   Q   R   S   T   U   V   W
+    KCLUT_ENTRY(1, 1, 1, 0, 0, 0, 1, 1),  // X   Y   Z   [   \   ]   ^   _
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // `   a   b   c   d   e   f   g
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // h   i   j   k   l   m   n   o
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // p   q   r   s   t   u   v   w
+    KCLUT_ENTRY(0, 0, 0, 1, 1, 1, 1, 0),  // x   y   z   {   |   }   ~   DEL
+};
+
+__attribute__((weak)) const uint8_t ascii_to_altgr_lut[16] = {0};
+
+__attribute__((weak)) const uint8_t ascii_to_keycode_lut[128] = {
+    // NUL   SOH      STX      ETX      EOT      ENQ      ACK      BEL
+    XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+    // BS    TAB      LF       VT       FF       CR       SO       SI
+    XXXXXXX, KC_TAB,  KC_ENT,  XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+    // DLE   DC1      DC2      DC3      DC4      NAK      SYN      ETB
+    XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+    // CAN   EM       SUB      ESC      FS       GS       RS       US
+    XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+
+    //       !        "        #        $        %        &        '
+    KC_SPC,  KC_1,    KC_QUOT, KC_3,    KC_4,    KC_5,    KC_7,    KC_QUOT,
+    // (     )        *        +        ,        -        .        /
+    KC_9,    KC_0,    KC_8,    KC_EQL,  KC_COMM, KC_MINS, KC_DOT,  KC_SLSH,
+    // 0     1        2        3        4        5        6        7
+    KC_0,    KC_1,    KC_2,    KC_3,    KC_4,    KC_5,    KC_6,    KC_7,
+    // 8     9        :        ;        <        =        >        ?
+    KC_8,    KC_9,    KC_SCLN, KC_SCLN, KC_COMM, KC_EQL,  KC_DOT,  KC_SLSH,
+    // @     A        B        C        D        E        F        G
+    KC_2,    KC_A,    KC_B,    KC_C,    KC_D,    KC_E,    KC_F,    KC_G,
+    // H     I        J        K        L        M        N        O
+    KC_H,    KC_I,    KC_J,    KC_K,    KC_L,    KC_M,    KC_N,    KC_O,
+    // P     Q        R        S        T        U        V        W
+    KC_P,    KC_Q,    KC_R,    KC_S,    KC_T,    KC_U,    KC_V,    KC_W,
+    // X     Y        Z        [        \        ]        ^        _
+    KC_X,    KC_Y,    KC_Z,    KC_LBRC, KC_BSLS, KC_RBRC, KC_6,    KC_MINS,
+    // `     a        b        c        d        e        f        g
+    KC_GRV,  KC_A,    KC_B,    KC_C,    KC_D,    KC_E,    KC_F,    KC_G,
+    // h     i        j        k        l        m        n        o
+    KC_H,    KC_I,    KC_J,    KC_K,    KC_L,    KC_M,    KC_N,    KC_O,
+    // p     q        r        s        t        u        v        w
+    KC_P,    KC_Q,    KC_R,    KC_S,    KC_T,    KC_U,    KC_V,    KC_W,
+    // x     y        z        {        |        }        ~        DEL
+    KC_X,    KC_Y,    KC_Z,    KC_LBRC, KC_BSLS, KC_RBRC, KC_GRV,  XXXXXXX,
+};
+// clang-format on
+
+// Same sequence as QMK's send_char(): mods down, tap, mods up.
+void send_char(char ascii_code) {
+  const uint8_t c = (uint8_t)ascii_code;
+  if (c >= 128) {
+    return;
+  }
+  const uint8_t keycode = pgm_read_byte(&ascii_to_keycode_lut[c]);
+  if (keycode == KC_NO) {
+    return;
+  }
+  const bool is_shifted = PGM_LOADBIT(ascii_to_shift_lut, c);
+  const bool is_altgred = PGM_LOADBIT(ascii_to_altgr_lut, c);
+  if (is_shifted) {
+    register_code(KC_LSFT);
+  }
+  if (is_altgred) {
+    register_code(KC_RALT);
+  }
+  tap_code(keycode);
+  if (is_altgred) {
+    unregister_code(KC_RALT);
+  }
+  if (is_shifted) {
+    unregister_code(KC_LSFT);
+  }
+}
+
+void send_string(const char* str) {
+  for (; *str; ++str) {
+    send_char(*str);
+  }
+}
+
+void send_string_P(const char* str) {
+  for (char c; (c = pgm_read_byte(str)); ++str) {
+    send_char(c);
+  }
+}
+
+// Layers
+
+__attribute__((weak)) layer_state_t layer_state_set_user(layer_state_t state) {
+  return state;
+}
+
+static void layer_state_set(layer_state_t state) {
+  layer_state = layer_state_set_user(state);
+}
+
+uint8_t get_highest_layer(layer_state_t state) {
+  return state ? 31 - __builtin_clz(state) : 0;
+}
+
+void layer_on(uint8_t layer) {
+  layer_state_set(layer_state | ((layer_state_t)1 << layer));
+}
+
+void layer_off(uint8_t layer) {
+  layer_state_set(layer_state & ~((layer_state_t)1 << layer));
+}
+
+void layer_move(uint8_t layer) {
+  layer_state_set((layer_state_t)1 << layer);
+}
+
+void layer_invert(uint8_t layer) {
+  layer_state_set(layer_state ^ ((layer_state_t)1 << layer));
+}
+
+void layer_and(layer_state_t state) { layer_state_set(layer_state & state); }
+void layer_or(layer_state_t state) { layer_state_set(layer_state | state); }
+void layer_clear(void) { layer_state_set(0); }
+
+// Caps Word, following quantum/process_keycode/process_caps_word.c.
+
+#ifndef CAPS_WORD_IDLE_TIMEOUT
+#define CAPS_WORD_IDLE_TIMEOUT 5000
+#endif
+
+static bool caps_word_active = false;
+static uint16_t caps_word_timer = 0;
+
+void caps_word_on(void) {
+  caps_word_active = true;
+  caps_word_timer = timer_read() + CAPS_WORD_IDLE_TIMEOUT;
+  clear_weak_mods();
+}
+
+void caps_word_off(void) {
+  if (caps_word_active) {
+    caps_word_active = false;
+    clear_weak_mods();
+    send_keyboard_report();
+  }
+}
+
+void caps_word_toggle(void) {
+  if (caps_word_active) {
+    caps_word_off();
+  } else {
+    caps_word_on();
+  }
+}
+
+bool is_caps_word_on(void) { return caps_word_active; }
+
+void caps_word_task(void) {
+  if (caps_word_active && timer_expired(timer_read(), caps_word_timer)) {
+    caps_word_off();
+  }
+}
+
+bool process_caps_word(uint16_t keycode, keyrecord_t* record) {
+  if (keycode == CW_TOGG) {
+    if (record->event.pressed) {
+      caps_word_toggle();
+    }
+    return false;
+  }
+  if (!caps_word_active || !record->event.pressed) {
+    return true;
+  }
+  if ((get_mods() | get_oneshot_mods()) &
+      ~(MOD_MASK_SHIFT | MOD_BIT(KC_RALT))) {
+    caps_word_off();
+    return true;
+  }
+  if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+    if (record->tap.count == 0) {
+      return true;
+    }
+    keycode &= 0xFF;
+  }
+  if (IS_MODIFIER_KEYCODE(keycode)) {
+    return true;
+  }
+
+  caps_word_timer = timer_read() + CAPS_WORD_IDLE_TIMEOUT;
+  clear_weak_mods();
+  if (!caps_word_press_user(keycode)) {
+    caps_word_off();
+  }
+  return true;
+}
+
+__attribute__((weak)) bool caps_word_press_user(uint16_t keycode) {
+  return false;
+}
+
+// Leader key, following quantum/process_keycode/process_leader.c.
+
+#ifndef LEADER_TIMEOUT
+#define LEADER_TIMEOUT 300
+#endif
+
+static bool leading = false;
+static uint16_t leader_time = 0;
+static uint16_t leader_sequence[5] = {0};
+static uint8_t leader_sequence_size = 0;
+
+bool leader_sequence_active(void) { return leading; }
+
+static bool leader_sequence_is(uint16_t kc1, uint16_t kc2, uint16_t kc3) {
+  return leader_sequence[0] == kc1 && leader_sequence[1] == kc2 &&
+         leader_sequence[2] == kc3 && leader_sequence[3] == 0;
+}
+
+bool leader_sequence_one_key(uint16_t kc) {
+  return leader_sequence_is(kc, 0, 0);
+}
+
+bool leader_sequence_two_keys(uint16_t kc1, uint16_t kc2) {
+  return leader_sequence_is(kc1, kc2, 0);
+}
+
+bool leader_sequence_three_keys(uint16_t kc1, uint16_t kc2, uint16_t kc3) {
+  return leader_sequence_is(kc1, kc2, kc3);
+}
+
+__attribute__((weak)) void leader_start_user(void) {}
+__attribute__((weak)) void leader_end_user(void) {}
+
+static void leader_end(void) {
+  leading = false;
+  leader_end_user();
+}
+
+void leader_task(void) {
+  if (leading && timer_elapsed(leader_time) > LEADER_TIMEOUT) {
+    leader_end();
+  }
+}
+
+bool process_leader(uint16_t keycode, keyrecord_t* record) {
+  if (!record->event.pressed) {
+    return true;
+  }
+  if (leading) {
+    if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+      keycode &= 0xFF;
+    }
+    if (leader_sequence_size < sizeof(leader_sequence) / sizeof(uint16_t)) {
+      leader_sequence[leader_sequence_size++] = keycode;
+    }
+#ifdef LEADER_PER_KEY_TIMING
+    leader_time = timer_read();
+#endif
+    return false;
+  }
+  if (keycode == QK_LEAD) {
+    leading = true;
+    leader_time = timer_read();
+    leader_sequence_size = 0;
+    memset(leader_sequence, 0, sizeof(leader_sequence));
+    leader_start_user();
+    return false;
+  }
+  return true;
+}
+
+// Dynamic macros, following quantum/process_keycode/process_dynamic_macro.c
+// with a single recording slot per macro.
+
+#ifndef DYNAMIC_MACRO_SIZE
+#define DYNAMIC_MACRO_SIZE 128
+#endif
+
+static keyrecord_t macro_buffer[2][DYNAMIC_MACRO_SIZE];
+static uint8_t macro_length[2] = {0};
+static int8_t macro_recording = -1;
+
+bool process_dynamic_macro(uint16_t keycode, keyrecord_t* record) {
+  if (macro_recording < 0) {
+    if (!record->event.pressed) {
+      switch (keycode) {
+        case DM_REC1:
+        case DM_REC2:
+          macro_recording = keycode - DM_REC1;
+          macro_length[macro_recording] = 0;
+          return false;
+        case DM_PLY1:
+        case DM_PLY2: {
+          const uint8_t id = keycode - DM_PLY1;
+          for (uint8_t i = 0; i < macro_length[id]; ++i) {
+            keyrecord_t replay = macro_buffer[id][i];
+            host_process_record(&replay);
+          }
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  switch (keycode) {
+    case DM_REC1:
+    case DM_REC2:
+    case DM_RSTP:
+    case DM_PLY1:
+    case DM_PLY2:
+      if (record->event.pressed ^ (keycode != DM_RSTP)) {
+        macro_recording = -1;
+      }
+      return false;
+  }
+  if (macro_length[macro_recording] < DYNAMIC_MACRO_SIZE) {
+    macro_buffer[macro_recording][macro_length[macro_recording]++] = *record;
+  }
+  return true;
+}
+
+// EEPROM, following platforms/eeprom.c. It starts out cleared and, like on
+// the board, survives host_reset(). Updates only write the bytes that change.
+static uint8_t eeprom[TOTAL_EEPROM_BYTE_COUNT];
+
+void eeprom_read_block(void* buf, const void* addr, size_t len) {
+  memcpy(buf, &eeprom[(uintptr_t)addr], len);
+}
+
+void eeprom_update_block(const void* buf, void* addr, size_t len) {
+  const uint8_t* bytes = buf;
+  uint8_t* target = &eeprom[(uintptr_t)addr];
+  uint32_t written = 0;
+  for (size_t i = 0; i < len; ++i) {
+    if (target[i] != bytes[i]) {
+      target[i] = bytes[i];
+      ++written;
+    }
+  }
+  if (written) {
+    ++host_stats.eeprom_writes;
+    host_stats.eeprom_bytes += written;
+  }
+}
+
+// User EEPROM datablock, following quantum/eeconfig.c.
+void eeconfig_read_user_datablock(void* data) {
+  eeprom_read_block(data, EECONFIG_USER_DATABLOCK, EECONFIG_USER_DATA_SIZE);
+}
+
+void eeconfig_update_user_datablock(const void* data) {
+  eeprom_update_block(data, EECONFIG_USER_DATABLOCK, EECONFIG_USER_DATA_SIZE);
+}
+
+// RGB matrix. Like the firmware, the effect starts out as a solid color.
+
+static uint8_t rgb_matrix_mode = RGB_MATRIX_SOLID_COLOR;
+static uint8_t rgb_matrix_last_mode = RGB_MATRIX_NONE;
+
+#ifdef RGB_MATRIX_CUSTOM_USER
+#define RGB_MATRIX_EFFECT(name)
+#define RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+#include "rgb_matrix_user.inc"
+#undef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+#undef RGB_MATRIX_EFFECT
+#endif  // RGB_MATRIX_CUSTOM_USER
+
+void host_rgb_matrix_render(void) {
+#ifdef RGB_MATRIX_CUSTOM_USER
+  effect_params_t params = {.init = rgb_matrix_mode != rgb_matrix_last_mode};
+#endif  // RGB_MATRIX_CUSTOM_USER
+  rgb_matrix_last_mode = rgb_matrix_mode;
+  switch (rgb_matrix_mode) {
+#ifdef RGB_MATRIX_CUSTOM_USER
+#define RGB_MATRIX_EFFECT(name)           \
+  case RGB_MATRIX_CUSTOM_##name:          \
+    while (name(&params)) {               \
+      ++params.iter;                      \
+    }                                     \
+    break;
+#include "rgb_matrix_user.inc"
+#undef RGB_MATRIX_EFFECT
+#endif  // RGB_MATRIX_CUSTOM_USER
+    default:
+      // Built-in effects aren't simulated, so their LED writes aren't counted.
+      break;
+  }
+}
+
+void rgb_matrix_set_color(int index, uint8_t red, uint8_t green,
+                          uint8_t blue) {
+  ++host_stats.led_writes;
+}
+
+uint8_t rgb_matrix_get_mode(void) { return rgb_matrix_mode; }
+void rgb_matrix_mode_noeeprom(uint8_t mode) { rgb_matrix_mode = mode; }
+bool rgb_matrix_is_enabled(void) { return true; }
+bool rgb_matrix_get_suspend_state(void) { return false; }
+
+// Weak user hooks
+
+__attribute__((weak)) void keyboard_post_init_user(void) {}
+__attribute__((weak)) void matrix_scan_user(void) {}
+__attribute__((weak)) void housekeeping_task_user(void) {}
+__attribute__((weak)) bool rgb_matrix_indicators_user(void) { return true; }
+
+void host_quantum_reset(void) {
+  real_mods = weak_mods = oneshot_mods = 0;
+  memset(report_keys, 0, sizeof(report_keys));
+  layer_state = 0;
+  default_layer_state = 1;
+  caps_word_active = false;
+  rgb_matrix_mode = RGB_MATRIX_SOLID_COLOR;
+  rgb_matrix_last_mode = RGB_MATRIX_NONE;
+  leading = false;
+  macro_recording = -1;
+  driver = &host_driver;
+}
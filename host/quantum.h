@@ -0,0 +1,316 @@
+/* Host stub of the QMK quantum layer.
+ *
+ * Declares just enough of the QMK API for keymap.c and the feature modules to
+ * compile natively. The implementation lives in quantum.c and keeps all state
+ * (clock, mods, layers, HID reports) in plain globals that the replay driver
+ * in main.c inspects.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "keycodes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Planck EZ matrix: the two halves are scanned as an 8x6 matrix.
+#define MATRIX_ROWS 8
+#define MATRIX_COLS 6
+#define RGB_MATRIX_LED_COUNT 47
+typedef uint8_t matrix_row_t;
+
+// Maps the visual 4x12 grid to the 8x6 matrix (right half on rows 4-7).
+// clang-format off
+#define LAYOUT_planck_grid( \
+    k00, k01, k02, k03, k04, k05, k06, k07, k08, k09, k0a, k0b, \
+    k10, k11, k12, k13, k14, k15, k16, k17, k18, k19, k1a, k1b, \
+    k20, k21, k22, k23, k24, k25, k26, k27, k28, k29, k2a, k2b, \
+    k30, k31, k32, k33, k34, k35, k36, k37, k38, k39, k3a, k3b  \
+) { \
+    { k00, k01, k02, k03, k04, k05 }, \
+    { k10, k11, k12, k13, k14, k15 }, \
+    { k20, k21, k22, k23, k24, k25 }, \
+    { k30, k31, k32, k33, k34, k35 }, \
+    { k06, k07, k08, k09, k0a, k0b }, \
+    { k16, k17, k18, k19, k1a, k1b }, \
+    { k26, k27, k28, k29, k2a, k2b }, \
+    { k36, k37, k38, k39, k3a, k3b }  \
+}
+// clang-format on
+
+// Flash access is plain memory access on the host.
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr) (*(void* const*)(addr))
+#define memcpy_P(dest, src, n) memcpy((dest), (src), (n))
+#define PSTR(s) (s)
+
+// Keyboard events
+typedef struct {
+  uint8_t col;
+  uint8_t row;
+} keypos_t;
+
+#define KEYEQ(keya, keyb) ((keya).row == (keyb).row && (keya).col == (keyb).col)
+
+typedef enum {
+  TICK_EVENT = 0,
+  KEY_EVENT = 1,
+  COMBO_EVENT = 4,
+} keyevent_type_t;
+
+typedef struct {
+  keypos_t key;
+  uint16_t time;
+  keyevent_type_t type;
+  bool pressed;
+} keyevent_t;
+
+typedef struct {
+  bool interrupted : 1;
+  uint8_t count : 4;
+} tap_t;
+
+typedef struct {
+  keyevent_t event;
+  tap_t tap;
+  uint16_t keycode;
+} keyrecord_t;
+
+// Position of combo events, which have no key of their own.
+#define KEYLOC_COMBO 254
+
+extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
+
+/** Keycode of `key` on `layer`, KC_TRNS if transparent. Weak like in QMK. */
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
+
+// Timer, driven by the simulated clock.
+uint16_t timer_read(void);
+uint32_t timer_read32(void);
+uint16_t timer_elapsed(uint16_t last);
+uint32_t timer_elapsed32(uint32_t last);
+#define timer_expired(current, future) ((uint16_t)(current - future) < 0x8000)
+#define timer_expired32(current, future) \
+  ((uint32_t)(current - future) < 0x80000000)
+
+// Modifiers
+#define MOD_BIT(kc) (1 << ((kc) & 0x07))
+#define MOD_MASK_CTRL (MOD_BIT(KC_LCTL) | MOD_BIT(KC_RCTL))
+#define MOD_MASK_SHIFT (MOD_BIT(KC_LSFT) | MOD_BIT(KC_RSFT))
+#define MOD_MASK_ALT (MOD_BIT(KC_LALT) | MOD_BIT(KC_RALT))
+#define MOD_MASK_GUI (MOD_BIT(KC_LGUI) | MOD_BIT(KC_RGUI))
+
+uint8_t get_mods(void);
+void add_mods(uint8_t mods);
+void del_mods(uint8_t mods);
+void set_mods(uint8_t mods);
+void clear_mods(void);
+void register_mods(uint8_t mods);
+void unregister_mods(uint8_t mods);
+uint8_t get_weak_mods(void);
+void add_weak_mods(uint8_t mods);
+void del_weak_mods(uint8_t mods);
+void clear_weak_mods(void);
+uint8_t get_oneshot_mods(void);
+void add_oneshot_mods(uint8_t mods);
+void set_oneshot_mods(uint8_t mods);
+void clear_oneshot_mods(void);
+uint8_t get_oneshot_layer(void);
+void reset_oneshot_layer(void);
+
+// Key output
+void register_code(uint8_t kc);
+void unregister_code(uint8_t kc);
+void tap_code(uint8_t kc);
+void register_code16(uint16_t kc);
+void unregister_code16(uint16_t kc);
+void tap_code16(uint16_t kc);
+void send_keyboard_report(void);
+void add_key(uint8_t kc);
+void del_key(uint8_t kc);
+void send_char(char ascii_code);
+void send_string(const char* str);
+void send_string_P(const char* str);
+#define SEND_STRING(string) send_string_P(PSTR(string))
+
+// Character tables of send_string(), for the host layout: the keycode typing
+// each ASCII character, and bitmaps of those that need Shift or AltGr.
+#define KCLUT_ENTRY(a, b, c, d, e, f, g, h)                          \
+  (((a) ? 1 : 0) << 0 | ((b) ? 1 : 0) << 1 | ((c) ? 1 : 0) << 2 |   \
+   ((d) ? 1 : 0) << 3 | ((e) ? 1 : 0) << 4 | ((f) ? 1 : 0) << 5 |   \
+   ((g) ? 1 : 0) << 6 | ((h) ? 1 : 0) << 7)
+#define PGM_LOADBIT(mem, pos) \
+  ((pgm_read_byte(&((mem)[(pos) / 8])) >> ((pos) % 8)) & 0x01)
+extern const uint8_t ascii_to_shift_lut[16];
+extern const uint8_t ascii_to_altgr_lut[16];
+extern const uint8_t ascii_to_keycode_lut[128];
+
+// HID host driver. Keyboard reports go out through its send_keyboard, which
+// instrumentation can wrap.
+typedef struct {
+  uint8_t mods;
+  uint8_t reserved;
+  uint8_t keys[6];
+} report_keyboard_t;
+typedef struct {
+  uint8_t (*keyboard_leds)(void);
+  void (*send_keyboard)(report_keyboard_t* report);
+  void (*send_nkro)(void* report);
+  void (*send_mouse)(void* report);
+  void (*send_extra)(void* report);
+} host_driver_t;
+host_driver_t* host_get_driver(void);
+void host_set_driver(host_driver_t* driver);
+
+// Layers
+typedef uint32_t layer_state_t;
+extern layer_state_t layer_state;
+extern layer_state_t default_layer_state;
+uint8_t get_highest_layer(layer_state_t state);
+#define IS_LAYER_ON(layer) (layer_state & ((layer_state_t)1 << (layer)))
+void layer_on(uint8_t layer);
+void layer_off(uint8_t layer);
+void layer_move(uint8_t layer);
+void layer_invert(uint8_t layer);
+void layer_and(layer_state_t state);
+void layer_or(layer_state_t state);
+void layer_clear(void);
+layer_state_t layer_state_set_user(layer_state_t state);
+
+// Caps Word
+void caps_word_on(void);
+void caps_word_off(void);
+void caps_word_toggle(void);
+bool is_caps_word_on(void);
+bool process_caps_word(uint16_t keycode, keyrecord_t* record);
+bool caps_word_press_user(uint16_t keycode);
+
+// Dynamic macros
+bool process_dynamic_macro(uint16_t keycode, keyrecord_t* record);
+
+// Leader key
+bool leader_sequence_active(void);
+bool leader_sequence_one_key(uint16_t kc);
+bool leader_sequence_two_keys(uint16_t kc1, uint16_t kc2);
+bool leader_sequence_three_keys(uint16_t kc1, uint16_t kc2, uint16_t kc3);
+void leader_start_user(void);
+void leader_end_user(void);
+
+// Combos and tap dance are declared so the keymap tables compile; the host
+// build does not resolve them.
+#define COMBO_END 0
+typedef struct {
+  const uint16_t* keys;
+  uint16_t keycode;
+} combo_t;
+#define COMBO(ck, ca) \
+  { .keys = &(ck)[0], .keycode = (ca) }
+
+typedef struct {
+  uint16_t kc1;
+  uint16_t kc2;
+} tap_dance_action_t;
+#define ACTION_TAP_DANCE_DOUBLE(kc_1, kc_2) \
+  { .kc1 = (kc_1), .kc2 = (kc_2) }
+
+// EEPROM, following platforms/eeprom.h, with the layout of quantum/eeconfig.h:
+// the base config, then the user datablock of EECONFIG_USER_DATA_SIZE bytes.
+// Keymaps may use the space from EECONFIG_SIZE on.
+#define TOTAL_EEPROM_BYTE_COUNT 2048
+#ifndef EECONFIG_USER_DATA_SIZE
+#define EECONFIG_USER_DATA_SIZE 0
+#endif
+#define EECONFIG_BASE_SIZE 37
+#define EECONFIG_USER_DATABLOCK ((uint8_t*)EECONFIG_BASE_SIZE)
+#define EECONFIG_SIZE (EECONFIG_BASE_SIZE + EECONFIG_USER_DATA_SIZE)
+void eeprom_read_block(void* buf, const void* addr, size_t len);
+void eeprom_update_block(const void* buf, void* addr, size_t len);
+void eeconfig_read_user_datablock(void* data);
+void eeconfig_update_user_datablock(const void* data);
+
+// RGB matrix
+typedef struct {
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+} RGB;
+// Effects the host knows: none, the solid color the firmware starts with, and
+// the keymap's own from rgb_matrix_user.inc with RGB_MATRIX_CUSTOM_USER.
+enum rgb_matrix_effects {
+  RGB_MATRIX_NONE = 0,
+  RGB_MATRIX_SOLID_COLOR,
+#ifdef RGB_MATRIX_CUSTOM_USER
+#define RGB_MATRIX_EFFECT(name) RGB_MATRIX_CUSTOM_##name,
+#include "rgb_matrix_user.inc"
+#undef RGB_MATRIX_EFFECT
+#endif  // RGB_MATRIX_CUSTOM_USER
+};
+// Effects render all LEDs in one go, as with no RGB_MATRIX_LED_PROCESS_LIMIT.
+typedef struct {
+  uint8_t iter;
+  bool init;
+} effect_params_t;
+#define RGB_MATRIX_USE_LIMITS(min, max) \
+  uint8_t min = 0;                      \
+  uint8_t max = RGB_MATRIX_LED_COUNT
+static inline bool rgb_matrix_check_finished_leds(uint8_t led_idx) {
+  return led_idx < RGB_MATRIX_LED_COUNT;
+}
+void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue);
+uint8_t rgb_matrix_get_mode(void);
+void rgb_matrix_mode_noeeprom(uint8_t mode);
+bool rgb_matrix_is_enabled(void);
+bool rgb_matrix_get_suspend_state(void);
+bool rgb_matrix_indicators_user(void);
+
+// Debug console. Output is formatted (so its cost is paid like on the board)
+// but only printed when the driver runs with -v.
+extern bool debug_enable;
+extern bool debug_matrix;
+extern bool debug_keyboard;
+int host_console_printf(const char* fmt, ...)
+    __attribute__((format(printf, 1, 2)));
+#define dprintf(...)                                \
+  do {                                              \
+    if (debug_enable) host_console_printf(__VA_ARGS__); \
+  } while (0)
+// Raw console output, as used by print.h.
+int8_t sendchar(uint8_t c);
+
+// uprintf is user output and always goes to stderr.
+int host_console_uprintf(const char* fmt, ...)
+    __attribute__((format(printf, 1, 2)));
+#define uprintf(...) host_console_uprintf(__VA_ARGS__)
+
+// Action layer entry points, for features that hold back key events: matrix
+// events before pre_process_record_user, the tap-hold stage they go to after
+// it, and record processing after tap-hold keys are resolved.
+void action_exec(keyevent_t event);
+void action_tapping_process(keyrecord_t record);
+void process_record(keyrecord_t* record);
+
+// User hooks implemented by the keymap
+bool pre_process_record_user(uint16_t keycode, keyrecord_t* record);
+bool process_record_user(uint16_t keycode, keyrecord_t* record);
+void keyboard_post_init_user(void);
+void matrix_scan_user(void);
+void housekeeping_task_user(void);
+uint16_t get_tapping_term(uint16_t keycode, keyrecord_t* record);
+bool get_hold_on_other_key_press(uint16_t keycode, keyrecord_t* record);
+bool get_permissive_hold(uint16_t keycode, keyrecord_t* record);
+// Declared for the keymap, quick tap isn't simulated.
+uint16_t get_quick_tap_term(uint16_t keycode, keyrecord_t* record);
+
+#ifdef __cplusplus
+}
+#endif
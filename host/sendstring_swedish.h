@@ -0,0 +1,85 @@
+/* Host stub of quantum/keymap_extras/sendstring_swedish.h.
+ *
+ * Must be included from exactly one translation unit (the keymap), where it
+ * replaces the default US tables used by send_string().
+ */
+
+#pragma once
+
+#include "keymap_swedish.h"
+
+// clang-format off
+const uint8_t ascii_to_shift_lut[16] PROGMEM = {
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // NUL SOH STX ETX EOT ENQ ACK BEL
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // BS  TAB LF  VT  FF  CR  SO  SI
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // DLE DC1 DC2 DC3 DC4 NAK SYN ETB
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // CAN EM  SUB ESC FS  GS  RS  US
+    KCLUT_ENTRY(0, 1, 1, 1, 0, 1, 1, 0),  //     !   "   #   $   %   &   '
+    KCLUT_ENTRY(1, 1, 1, 0, 0, 0, 0, 1),  // (   )   *   +   ,   -   .   /
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // 0   1   2   3   4   5   6   7
+    KCLUT_ENTRY(0, 0, 1, 1, 0, 1, 1, 1),  // 8   9   :   ;   <   =   >   ?
+    KCLUT_ENTRY(0, 1, 1, 1, 1, 1, 1, 1),  // @   A   B   C   D   E   F   G
+    KCLUT_ENTRY(1, 1, 1, 1, 1, 1, 1, 1),  // H   I   J   K   L   M   N   O
+    KCLUT_ENTRY(1, 1, 1, 1, 1, 1, 1, 1),  // P   Q   R   S   T   U   V   W
+    KCLUT_ENTRY(1, 1, 1, 0, 0, 0, 1, 1),  // X   Y   Z   [   \   ]   ^   _
+    KCLUT_ENTRY(1, 0, 0, 0, 0, 0, 0, 0),  // `   a   b   c   d   e   f   g
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // h   i   j   k   l   m   n   o
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // p   q   r   s   t   u   v   w
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // x   y   z   {   |   }   ~   DEL
+};
+
+const uint8_t ascii_to_altgr_lut[16] PROGMEM = {
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // NUL SOH STX ETX EOT ENQ ACK BEL
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // BS  TAB LF  VT  FF  CR  SO  SI
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // DLE DC1 DC2 DC3 DC4 NAK SYN ETB
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // CAN EM  SUB ESC FS  GS  RS  US
+    KCLUT_ENTRY(0, 0, 0, 0, 1, 0, 0, 0),  //     !   "   #   $   %   &   '
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // (   )   *   +   ,   -   .   /
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // 0   1   2   3   4   5   6   7
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // 8   9   :   ;   <   =   >   ?
+    KCLUT_ENTRY(1, 0, 0, 0, 0, 0, 0, 0),  // @   A   B   C   D   E   F   G
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // H   I   J   K   L   M   N   O
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // P   Q   R   S   T   U   V   W
+    KCLUT_ENTRY(0, 0, 0, 1, 1, 1, 0, 0),  // X   Y   Z   [   \   ]   ^   _
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // `   a   b   c   d   e   f   g
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // h   i   j   k   l   m   n   o
+    KCLUT_ENTRY(0, 0, 0, 0, 0, 0, 0, 0),  // p   q   r   s   t   u   v   w
+    KCLUT_ENTRY(0, 0, 0, 1, 1, 1, 1, 0),  // x   y   z   {   |   }   ~   DEL
+};
+
+const uint8_t ascii_to_keycode_lut[128] PROGMEM = {
+    // NUL   SOH      STX      ETX      EOT      ENQ      ACK      BEL
+    XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+    // BS    TAB      LF       VT       FF       CR       SO       SI
+    XXXXXXX, KC_TAB,  KC_ENT,  XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+    // DLE   DC1      DC2      DC3      DC4      NAK      SYN      ETB
+    XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+    // CAN   EM       SUB      ESC      FS       GS       RS       US
+    XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX, XXXXXXX,
+
+    //       !        "        #        $        %        &        '
+    KC_SPC,  KC_1,    KC_2,    KC_3,    KC_4,    KC_5,    KC_6,    SE_QUOT,
+    // (     )        *        +        ,        -        .        /
+    KC_8,    KC_9,    SE_QUOT, SE_PLUS, KC_COMM, SE_MINS, KC_DOT,  KC_7,
+    // 0     1        2        3        4        5        6        7
+    KC_0,    KC_1,    KC_2,    KC_3,    KC_4,    KC_5,    KC_6,    KC_7,
+    // 8     9        :        ;        <        =        >        ?
+    KC_8,    KC_9,    KC_DOT,  KC_COMM, SE_LABK, KC_0,    SE_LABK, SE_PLUS,
+    // @     A        B        C        D        E        F        G
+    KC_2,    KC_A,    KC_B,    KC_C,    KC_D,    KC_E,    KC_F,    KC_G,
+    // H     I        J        K        L        M        N        O
+    KC_H,    KC_I,    KC_J,    KC_K,    KC_L,    KC_M,    KC_N,    KC_O,
+    // P     Q        R        S        T        U        V        W
+    KC_P,    KC_Q,    KC_R,    KC_S,    KC_T,    KC_U,    KC_V,    KC_W,
+    // X     Y        Z        [        \        ]        ^        _
+    KC_X,    KC_Y,    KC_Z,    KC_8,    SE_PLUS, KC_9,    SE_DIAE, SE_MINS,
+    // `     a        b        c        d        e        f        g
+    SE_ACUT, KC_A,    KC_B,    KC_C,    KC_D,    KC_E,    KC_F,    KC_G,
+    // h     i        j        k        l        m        n        o
+    KC_H,    KC_I,    KC_J,    KC_K,    KC_L,    KC_M,    KC_N,    KC_O,
+    // p     q        r        s        t        u        v        w
+    KC_P,    KC_Q,    KC_R,    KC_S,    KC_T,    KC_U,    KC_V,    KC_W,
+    // x     y        z        {        |        }        ~        DEL
+    KC_X,    KC_Y,    KC_Z,    KC_7,    SE_LABK, KC_0,    SE_DIAE, XXXXXXX,
+};
+// clang-format on
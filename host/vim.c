@@ -0,0 +1,12 @@
+/* Host stub of qmk-vim. See qmk-vim/src/vim.h. */
+
+#include "qmk-vim/src/vim.h"
+
+static bool vim_enabled = false;
+
+bool vim_mode_enabled(void) { return vim_enabled; }
+void enable_vim_mode(void) { vim_enabled = true; }
+void disable_vim_mode(void) { vim_enabled = false; }
+void toggle_vim_mode(void) { vim_enabled = !vim_enabled; }
+
+bool process_vim_mode(uint16_t keycode, keyrecord_t *record) { return true; }
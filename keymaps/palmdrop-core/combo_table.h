@@ -0,0 +1,43 @@
+// Generated by scripts/gen_combos.py from combos.txt and keymap.c, do not edit.
+
+#pragma once
+
+#define POSITION_COMBO_COUNT 3
+#define POSITION_COMBO_MAX_SIZE 2
+
+typedef uint8_t position_combo_mask_t;
+
+// The tables are only defined in features/position_combos.c.
+#ifdef POSITION_COMBO_TABLES
+
+static const position_combo_mask_t PROGMEM
+    position_combo_index[MATRIX_ROWS][MATRIX_COLS] = {
+    {0x0, 0x0, 0x0, 0x0, 0x0, 0x0},
+    {0x0, 0x0, 0x1, 0x1, 0x2, 0x0},
+    {0x0, 0x0, 0x0, 0x0, 0x0, 0x0},
+    {0x0, 0x0, 0x0, 0x0, 0x0, 0x0},
+    {0x0, 0x0, 0x0, 0x0, 0x0, 0x0},
+    {0x0, 0x6, 0x4, 0x0, 0x0, 0x0},
+    {0x0, 0x0, 0x0, 0x0, 0x0, 0x0},
+    {0x0, 0x0, 0x0, 0x0, 0x0, 0x0},
+};
+
+static const uint8_t PROGMEM position_combo_sizes[] = {
+    2,  // HR_S HR_D
+    2,  // HR_F HR_J
+    2,  // HR_J HR_K
+};
+
+static const uint16_t PROGMEM position_combo_keycodes[] = {
+    KC_LGUI,  // HR_S HR_D
+    KC_ESC,  // HR_F HR_J
+    KC_BSPC,  // HR_J HR_K
+};
+
+static const uint8_t PROGMEM position_combo_terms[] = {
+    COMBO_TERM,  // HR_S HR_D
+    40,  // HR_F HR_J
+    40,  // HR_J HR_K
+};
+
+#endif  // POSITION_COMBO_TABLES
@@ -25,10 +25,13 @@
 
 #define TAPPING_TERM 170 
 #define QUICK_TAP_TERM 0
-#define DEBOUNCE 10
-#define COMBO_TERM 50
-#define LEADER_TIMEOUT 300
-#define LEADER_PER_KEY_TIMING
+#define DEBOUNCE 10 // Per key with EAGER_DEBOUNCE_ENABLE, see debounce_times in features/eager_debounce.h
+#define COMBO_TERM 50 // Default, combos.txt sets it per combo
+#define SPECULATIVE_TAP_STREAK 125 // Home row mods pressed this soon after a letter are letters
+#define EECONFIG_USER_DATA_SIZE 18 // Learned tapping terms, ADAPTIVE_TAPPING_EEPROM_SIZE
+#define SCHEDULER_SLOTS 8 // Layer lock, Sentence Case, leader, combo, tap dance, tapping term save, macro save and playback
+#define LEADER_TIMEOUT 300 // Since the last key, only waited for when a sequence is a prefix of another one
+#define PIPELINE_PROFILE_MAX_STAGES 16 // A stage per feature in keymap.c, FEATURE_CHAIN_MAX
 
 // Make home row mods usable
 #define PERMISSIVE_HOLD_PER_KEY
@@ -40,8 +43,10 @@
 // to avoid accidentally triggering the tap action.
 #define HOLD_ON_OTHER_KEY_PRESS_PER_KEY
 
-// Enables stopping macro recording by tapping layer keys for layer used to access macro record keys
-#define DYNAMIC_MACRO_USER_CALL
+// Tapping terms, quick tap terms and the above per key come from tap_hold_keys in keymap.c.
+// Adaptive tapping also needs TAPPING_TERM_PER_KEY, QMK only calls get_tapping_term() with it.
+#define TAPPING_TERM_PER_KEY
+#define QUICK_TAP_TERM_PER_KEY
 
 #define MOUSEKEY_DELAY 0
 #define MOUSEKEY_TIME_TO_MAX 60
@@ -54,6 +59,7 @@
 
 // Special features
 #define LAYER_LOCK_IDLE_TIMEOUT 60000 // Disable layer locks after 10s of idle time
+#define SENTENCE_CASE_ABBREVIATIONS // Exceptions from abbreviations.txt, see scripts/gen_abbreviations.py
 
 // From default
 #ifdef AUDIO_ENABLE
@@ -0,0 +1,246 @@
+/**
+ * @file adaptive_tapping.c
+ * @brief Adaptive tapping implementation
+ */
+
+#include "adaptive_tapping.h"
+
+#include <string.h>
+
+#include "scheduler.h"
+#include "trace_buffer.h"
+
+#if !defined(EECONFIG_USER_DATA_SIZE) || \
+    EECONFIG_USER_DATA_SIZE < ADAPTIVE_TAPPING_EEPROM_SIZE
+#error "adaptive_tapping: EECONFIG_USER_DATA_SIZE must be at least ADAPTIVE_TAPPING_EEPROM_SIZE"
+#endif
+
+#ifndef TAPPING_TERM_PER_KEY
+#error "adaptive_tapping: define TAPPING_TERM_PER_KEY, or QMK never calls get_tapping_term()"
+#endif
+
+// Tap durations 0-15 ms, 16-31 ms, ... 304 ms and more.
+#define BUCKET_MS 16
+#define HISTOGRAM_SIZE 20
+
+// Holds this much over the term with no other key count as slow taps.
+#define SLOW_TAP_MS 50
+
+// Moving averages are in 1/16 ms and move 1/8 of the way to each sample.
+#define AVERAGE_SHIFT 4
+#define AVERAGE_WEIGHT 3
+
+// Changes when the slot count does, so stale layouts aren't loaded.
+#define EEPROM_MAGIC (0xA700 | ADAPTIVE_TAPPING_SLOTS)
+
+typedef struct {
+  uint16_t magic;
+  uint16_t terms[ADAPTIVE_TAPPING_SLOTS];
+} adaptive_tapping_eeprom_t;
+
+typedef struct {
+  uint16_t keycode;  // Last seen, for printing.
+  uint16_t term;     // Learned term, 0 if none yet.
+  // The press being timed, and the first other key pressed during it.
+  bool held;
+  bool interrupted;
+  uint16_t press_time;
+  uint16_t other_press_time;
+  // Tap statistics.
+  uint8_t histogram[HISTOGRAM_SIZE];
+  uint16_t taps;
+  uint8_t taps_since_update;
+  uint16_t tap_average;
+  uint16_t rolls;
+  uint16_t overlap_average;
+} adaptive_tapping_slot_t;
+
+static adaptive_tapping_slot_t slots[ADAPTIVE_TAPPING_SLOTS];
+static scheduler_token_t save_token = SCHEDULER_NO_TOKEN;
+
+__attribute__((weak)) uint8_t adaptive_tapping_slot(uint16_t keycode) {
+  return ADAPTIVE_TAPPING_NONE;
+}
+
+static void save_terms(void) {
+  uint8_t block[EECONFIG_USER_DATA_SIZE] = {0};
+  adaptive_tapping_eeprom_t data = {.magic = EEPROM_MAGIC};
+  for (uint8_t i = 0; i < ADAPTIVE_TAPPING_SLOTS; ++i) {
+    data.terms[i] = slots[i].term;
+  }
+  memcpy(block, &data, sizeof(data));
+  eeconfig_update_user_datablock(block);
+}
+
+static uint32_t adaptive_tapping_save(uint32_t now, void* arg) {
+  save_token = SCHEDULER_NO_TOKEN;
+  save_terms();
+  return 0;
+}
+
+void adaptive_tapping_init(void) {
+  uint8_t block[EECONFIG_USER_DATA_SIZE];
+  adaptive_tapping_eeprom_t data;
+  eeconfig_read_user_datablock(block);
+  memcpy(&data, block, sizeof(data));
+  if (data.magic != EEPROM_MAGIC) {
+    return;  // Erased, or saved with another slot count.
+  }
+  for (uint8_t i = 0; i < ADAPTIVE_TAPPING_SLOTS; ++i) {
+    const uint16_t term = data.terms[i];
+    if (term >= ADAPTIVE_TAPPING_MIN && term <= ADAPTIVE_TAPPING_MAX) {
+      slots[i].term = term;
+    }
+  }
+}
+
+static void average_add(uint16_t* average, uint16_t sample) {
+  if (sample > (UINT16_MAX >> AVERAGE_SHIFT)) {
+    sample = UINT16_MAX >> AVERAGE_SHIFT;
+  }
+  const int32_t delta = ((int32_t)sample << AVERAGE_SHIFT) - *average;
+  *average += delta / (1 << AVERAGE_WEIGHT);
+}
+
+// Upper edge of the bucket holding the percentile of tap durations.
+static uint16_t tap_percentile(const adaptive_tapping_slot_t* slot,
+                               uint8_t percentile) {
+  uint16_t total = 0;
+  for (uint8_t i = 0; i < HISTOGRAM_SIZE; ++i) {
+    total += slot->histogram[i];
+  }
+  const uint32_t needed = ((uint32_t)total * percentile + 99) / 100;
+  uint16_t count = 0;
+  for (uint8_t i = 0; i < HISTOGRAM_SIZE; ++i) {
+    count += slot->histogram[i];
+    if (count >= needed) {
+      return (i + 1) * BUCKET_MS;
+    }
+  }
+  return HISTOGRAM_SIZE * BUCKET_MS;
+}
+
+// Moves the term towards the percentile of tap durations plus the margin.
+static void adapt_term(uint8_t index, uint16_t current) {
+  adaptive_tapping_slot_t* slot = &slots[index];
+  int16_t target = tap_percentile(slot, ADAPTIVE_TAPPING_PERCENTILE) +
+                   ADAPTIVE_TAPPING_MARGIN;
+  if (target < current - ADAPTIVE_TAPPING_STEP) {
+    target = current - ADAPTIVE_TAPPING_STEP;
+  } else if (target > current + ADAPTIVE_TAPPING_STEP) {
+    target = current + ADAPTIVE_TAPPING_STEP;
+  }
+  if (target < ADAPTIVE_TAPPING_MIN) {
+    target = ADAPTIVE_TAPPING_MIN;
+  } else if (target > ADAPTIVE_TAPPING_MAX) {
+    target = ADAPTIVE_TAPPING_MAX;
+  }
+  if (target == slot->term) {
+    return;
+  }
+  slot->term = target;
+  TRACE(TAPPING_TERM, index, target, current);
+  if (save_token == SCHEDULER_NO_TOKEN) {
+    save_token = scheduler_defer(ADAPTIVE_TAPPING_SAVE_DELAY,
+                                 adaptive_tapping_save, NULL);
+  }
+}
+
+static void add_tap(uint8_t index, uint16_t duration, uint16_t current) {
+  adaptive_tapping_slot_t* slot = &slots[index];
+  const uint8_t bucket = duration / BUCKET_MS < HISTOGRAM_SIZE
+                             ? duration / BUCKET_MS
+                             : HISTOGRAM_SIZE - 1;
+  if (slot->histogram[bucket] == UINT8_MAX) {
+    // Halve everything so that newer taps outweigh older ones.
+    for (uint8_t i = 0; i < HISTOGRAM_SIZE; ++i) {
+      slot->histogram[i] >>= 1;
+    }
+  }
+  ++slot->histogram[bucket];
+  average_add(&slot->tap_average, duration);
+  if (slot->taps < UINT16_MAX) {
+    ++slot->taps;
+  }
+  if (++slot->taps_since_update >= ADAPTIVE_TAPPING_UPDATE &&
+      slot->taps >= ADAPTIVE_TAPPING_MIN_TAPS) {
+    slot->taps_since_update = 0;
+    adapt_term(index, current);
+  }
+}
+
+void adaptive_tapping_record(uint16_t keycode, keyrecord_t* record) {
+  const uint16_t time = record->event.time;
+  const uint8_t index = record->event.type == KEY_EVENT
+                            ? adaptive_tapping_slot(keycode)
+                            : ADAPTIVE_TAPPING_NONE;
+  adaptive_tapping_slot_t* slot =
+      index < ADAPTIVE_TAPPING_SLOTS ? &slots[index] : NULL;
+
+  if (record->event.pressed) {
+    // Every held key is interrupted by this press.
+    for (uint8_t i = 0; i < ADAPTIVE_TAPPING_SLOTS; ++i) {
+      if (slots[i].held && !slots[i].interrupted && &slots[i] != slot) {
+        slots[i].interrupted = true;
+        slots[i].other_press_time = time;
+      }
+    }
+    if (slot) {
+      slot->keycode = keycode;
+      slot->held = true;
+      slot->interrupted = false;
+      slot->press_time = time;
+    }
+    return;
+  }
+
+  if (!slot || !slot->held) {
+    return;
+  }
+  slot->held = false;
+  const uint16_t duration = time - slot->press_time;
+  const uint16_t current = get_tapping_term(keycode, record);
+  if (record->tap.count) {
+    if (slot->interrupted) {
+      // Rolled into the next key before releasing this one.
+      if (slot->rolls < UINT16_MAX) {
+        ++slot->rolls;
+      }
+      average_add(&slot->overlap_average, time - slot->other_press_time);
+    }
+    add_tap(index, duration, current);
+  } else if (!slot->interrupted && duration < current + SLOW_TAP_MS) {
+    add_tap(index, duration, current);  // A hold that didn't do anything.
+  }
+}
+
+uint16_t adaptive_tapping_term(uint16_t keycode, uint16_t term) {
+  const uint8_t index = adaptive_tapping_slot(keycode);
+  if (index < ADAPTIVE_TAPPING_SLOTS && slots[index].term) {
+    return slots[index].term;
+  }
+  return term;
+}
+
+void adaptive_tapping_print(void) {
+  uprintf("slot keycode term  taps  avg  p50  p%u rolls overlap\n",
+          ADAPTIVE_TAPPING_PERCENTILE);
+  for (uint8_t i = 0; i < ADAPTIVE_TAPPING_SLOTS; ++i) {
+    const adaptive_tapping_slot_t* slot = &slots[i];
+    if (!slot->taps && !slot->term) {
+      continue;
+    }
+    uprintf("%4u  0x%04X %4u %5u %4u %4u %4u %5u %7u\n", i, slot->keycode,
+            slot->term, slot->taps, slot->tap_average >> AVERAGE_SHIFT,
+            slot->taps ? tap_percentile(slot, 50) : 0,
+            slot->taps ? tap_percentile(slot, ADAPTIVE_TAPPING_PERCENTILE) : 0,
+            slot->rolls, slot->overlap_average >> AVERAGE_SHIFT);
+  }
+}
+
+void adaptive_tapping_reset(void) {
+  memset(slots, 0, sizeof(slots));
+  scheduler_cancel(save_token);
+  save_token = SCHEDULER_NO_TOKEN;
+  save_terms();
+}
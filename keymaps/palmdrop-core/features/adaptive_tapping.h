@@ -0,0 +1,136 @@
+/**
+ * @file adaptive_tapping.h
+ * @brief Adaptive tapping: tapping terms learned from how keys are typed.
+ *
+ * Instead of hand tuning `get_tapping_term()`, this watches the tap-hold keys
+ * it is given slots for and learns each key's term from its taps:
+ *
+ *  * every tap adds its duration, press to release, to a histogram of 16 ms
+ *    buckets and to a moving average. Holds released before `term + 50` ms
+ *    with no other key pressed in between did nothing, so they count as slow
+ *    taps. The histogram is halved when a bucket fills up, so old taps fade,
+ *  * every `ADAPTIVE_TAPPING_UPDATE` taps, once the key has
+ *    `ADAPTIVE_TAPPING_MIN_TAPS`, the term moves towards the
+ *    `ADAPTIVE_TAPPING_PERCENTILE` of tap durations plus
+ *    `ADAPTIVE_TAPPING_MARGIN`, by at most `ADAPTIVE_TAPPING_STEP` ms and
+ *    within `ADAPTIVE_TAPPING_MIN` and `ADAPTIVE_TAPPING_MAX`,
+ *  * learned terms are saved to the user EEPROM datablock
+ *    `ADAPTIVE_TAPPING_SAVE_DELAY` ms after they change, so bursts of
+ *    changes cost one write, and are loaded again on boot.
+ *
+ * The moving average of the overlap of rolls, from pressing the next key to
+ * releasing the tap-hold key, is kept alongside for `adaptive_tapping_print()`.
+ *
+ * Give keys a slot from 0 to `ADAPTIVE_TAPPING_SLOTS - 1` in keymap.c:
+ *
+ *     uint8_t adaptive_tapping_slot(uint16_t keycode) {
+ *       switch (keycode) {
+ *         case HR_S: return 0;
+ *         case HR_D: return 1;
+ *         default: return ADAPTIVE_TAPPING_NONE;
+ *       }
+ *     }
+ *
+ * and return `adaptive_tapping_term(keycode, term)` from `get_tapping_term()`,
+ * where `term` is used until the key has a learned one. QMK only calls
+ * `get_tapping_term()` with `TAPPING_TERM_PER_KEY` defined in config.h. Call
+ * `adaptive_tapping_init()` from `keyboard_post_init_user()` and
+ * `adaptive_tapping_record()` from `process_record_user()`. Set
+ * `EECONFIG_USER_DATA_SIZE` to at least `ADAPTIVE_TAPPING_EEPROM_SIZE` in
+ * config.h. The save runs on the scheduler, see features/scheduler.h.
+ *
+ * Enable with `ADAPTIVE_TAPPING_ENABLE = yes` in rules.mk. When disabled,
+ * `adaptive_tapping_term()` returns the given term.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of keys whose terms are learned.
+#ifndef ADAPTIVE_TAPPING_SLOTS
+#define ADAPTIVE_TAPPING_SLOTS 8
+#endif  // ADAPTIVE_TAPPING_SLOTS
+
+// Bounds of learned terms in ms.
+#ifndef ADAPTIVE_TAPPING_MIN
+#define ADAPTIVE_TAPPING_MIN 120
+#endif  // ADAPTIVE_TAPPING_MIN
+#ifndef ADAPTIVE_TAPPING_MAX
+#define ADAPTIVE_TAPPING_MAX 300
+#endif  // ADAPTIVE_TAPPING_MAX
+
+// Percentile of tap durations the term should cover, and the ms added to it.
+#ifndef ADAPTIVE_TAPPING_PERCENTILE
+#define ADAPTIVE_TAPPING_PERCENTILE 95
+#endif  // ADAPTIVE_TAPPING_PERCENTILE
+#ifndef ADAPTIVE_TAPPING_MARGIN
+#define ADAPTIVE_TAPPING_MARGIN 20
+#endif  // ADAPTIVE_TAPPING_MARGIN
+
+// Taps before a key's term adapts, taps between updates, and the largest
+// change of an update in ms.
+#ifndef ADAPTIVE_TAPPING_MIN_TAPS
+#define ADAPTIVE_TAPPING_MIN_TAPS 32
+#endif  // ADAPTIVE_TAPPING_MIN_TAPS
+#ifndef ADAPTIVE_TAPPING_UPDATE
+#define ADAPTIVE_TAPPING_UPDATE 16
+#endif  // ADAPTIVE_TAPPING_UPDATE
+#ifndef ADAPTIVE_TAPPING_STEP
+#define ADAPTIVE_TAPPING_STEP 10
+#endif  // ADAPTIVE_TAPPING_STEP
+
+// Delay in ms from a term changing to saving it to EEPROM.
+#ifndef ADAPTIVE_TAPPING_SAVE_DELAY
+#define ADAPTIVE_TAPPING_SAVE_DELAY 60000
+#endif  // ADAPTIVE_TAPPING_SAVE_DELAY
+
+/** Slot of keys whose term isn't learned. */
+#define ADAPTIVE_TAPPING_NONE 0xFF
+
+/** Bytes of the user EEPROM datablock used for the learned terms. */
+#define ADAPTIVE_TAPPING_EEPROM_SIZE (2 + 2 * ADAPTIVE_TAPPING_SLOTS)
+
+/**
+ * Callback, slot of `keycode` or `ADAPTIVE_TAPPING_NONE`. The default gives
+ * no key a slot.
+ */
+uint8_t adaptive_tapping_slot(uint16_t keycode);
+
+#ifdef ADAPTIVE_TAPPING_ENABLE
+
+/** Loads the learned terms. Call from `keyboard_post_init_user()`. */
+void adaptive_tapping_init(void);
+
+/** Learns from a key event. Call from `process_record_user()`. */
+void adaptive_tapping_record(uint16_t keycode, keyrecord_t* record);
+
+/** Learned term of `keycode`, or `term` if it has none. */
+uint16_t adaptive_tapping_term(uint16_t keycode, uint16_t term);
+
+/** Prints each slot's term, tap statistics and roll overlap to the console. */
+void adaptive_tapping_print(void);
+
+/** Forgets the statistics and learned terms, also in EEPROM. */
+void adaptive_tapping_reset(void);
+
+#else
+
+static inline void adaptive_tapping_init(void) {}
+static inline void adaptive_tapping_record(uint16_t keycode,
+                                           keyrecord_t* record) {}
+static inline uint16_t adaptive_tapping_term(uint16_t keycode, uint16_t term) {
+  return term;
+}
+static inline void adaptive_tapping_print(void) {}
+static inline void adaptive_tapping_reset(void) {}
+
+#endif  // ADAPTIVE_TAPPING_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
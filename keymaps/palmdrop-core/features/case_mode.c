@@ -0,0 +1,144 @@
+/**
+ * @file case_mode.c
+ * @brief Case mode implementation
+ */
+
+#include "case_mode.h"
+#include "keymap_swedish.h"
+
+static case_mode_t mode = CASE_MODE_OFF;
+// Whether the next letter starts a word, and whether the last key pressed was
+// a space that typed the separator.
+static bool capitalize = false;
+static bool after_space = false;
+// Key whose letter is shifted, until it's released or another key is pressed.
+static bool shifted = false;
+static keypos_t shifted_key;
+
+static void unshift(void) {
+  if (shifted) {
+    del_weak_mods(MOD_BIT(KC_LSFT));
+    shifted = false;
+  }
+}
+
+static bool is_letter(uint16_t keycode) {
+  switch (keycode) {
+    case KC_A ... KC_Z:
+    case SE_ARNG:
+    case SE_ADIA:
+    case SE_ODIA:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Keycode typing the separator between words, KC_NO if there is none.
+static uint16_t separator(void) {
+  switch (mode) {
+    case CASE_MODE_SNAKE:
+    case CASE_MODE_CONSTANT:
+      return SE_UNDS;
+    case CASE_MODE_KEBAB:
+      return SE_MINS;
+    case CASE_MODE_DOT:
+      return KC_DOT;
+    default:
+      return KC_NO;
+  }
+}
+
+// Space between words: the separator, or the next letter shifted.
+static bool process_space(void) {
+  if (after_space) {
+    // A second space ends the identifier with a space after it.
+    if (separator() != KC_NO) {
+      tap_code(KC_BSPC);
+    }
+    case_mode_off();
+    return true;
+  }
+  after_space = true;
+  if (separator() != KC_NO) {
+    tap_code16(separator());
+  } else {
+    capitalize = true;
+  }
+  return false;
+}
+
+bool process_case_mode(uint16_t keycode, keyrecord_t* record) {
+  if (!record->event.pressed) {
+    if (shifted && KEYEQ(record->event.key, shifted_key)) {
+      unshift();
+    }
+    return true;
+  }
+  if (mode == CASE_MODE_OFF) {
+    return true;
+  }
+  unshift();
+
+  switch (keycode) {
+    // Tap-hold keys are the key they tap, holding them leaves the mode on.
+    case QK_MOD_TAP ... QK_MOD_TAP_MAX:
+    case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
+      if (!record->tap.count) {
+        return true;
+      }
+      keycode &= 0xFF;
+      break;
+    case KC_LEFT_CTRL ... KC_RIGHT_GUI:
+    case QK_LAYER_MOD ... QK_LAYER_TAP_TOGGLE_MAX:
+      return true;
+  }
+
+  // Shortcuts end the identifier, shifted keys are typed as they are.
+  if ((get_mods() | get_oneshot_mods()) & ~MOD_MASK_SHIFT) {
+    case_mode_off();
+    return true;
+  }
+
+  if (keycode == KC_SPC) {
+    return process_space();
+  }
+  after_space = false;
+
+  if (is_letter(keycode)) {
+    if (capitalize || mode == CASE_MODE_CONSTANT) {
+      add_weak_mods(MOD_BIT(KC_LSFT));
+      shifted = true;
+      shifted_key = record->event.key;
+      capitalize = false;
+    }
+    return true;
+  }
+
+  switch (keycode) {
+    case KC_1 ... KC_0:
+    case SE_UNDS:
+    case SE_MINS:
+    case KC_BSPC:
+    case KC_DEL:
+      return true;
+  }
+
+  case_mode_off();
+  return true;
+}
+
+void case_mode_on(case_mode_t new_mode) {
+  unshift();
+  mode = new_mode;
+  capitalize = mode == CASE_MODE_PASCAL;
+  after_space = false;
+}
+
+void case_mode_off(void) {
+  case_mode_on(CASE_MODE_OFF);
+}
+
+case_mode_t case_mode_get(void) {
+  return mode;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file case_mode.h
+ * @brief Case mode: identifiers typed as words, cased on the fly.
+ *
+ * While a case mode is on, words are typed with spaces between them as usual
+ * and come out as one identifier:
+ *
+ *   - camelCase and PascalCase drop the space and shift the next letter,
+ *   - snake_case and CONSTANT_CASE type an underscore, CONSTANT shifts every
+ *     letter,
+ *   - kebab-case types a minus and dot.case a dot.
+ *
+ * Letters, digits, underscore, minus and backspace continue the identifier,
+ * and so do modifiers and layer keys held on their own. Any other key ends
+ * the mode and goes through as usual, and so does a second space in a row,
+ * which takes back the separator the first one typed.
+ *
+ * Each key is a switch on its keycode: nothing changes layers, and the shift
+ * applied to a letter is a weak mod that's only there until the letter is
+ * released or the next key is pressed.
+ *
+ * Turn a mode on with `case_mode_on()` from a custom keycode, and call
+ * `process_case_mode()` from `process_record_user()`.
+ *
+ * Enable with `CASE_MODE_ENABLE = yes` in rules.mk.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  CASE_MODE_OFF,
+  CASE_MODE_CAMEL,     // camelCase
+  CASE_MODE_PASCAL,    // PascalCase
+  CASE_MODE_SNAKE,     // snake_case
+  CASE_MODE_CONSTANT,  // CONSTANT_CASE
+  CASE_MODE_KEBAB,     // kebab-case
+  CASE_MODE_DOT,       // dot.case
+} case_mode_t;
+
+#ifdef CASE_MODE_ENABLE
+
+/** Handler function for case mode, returns false if the key was consumed. */
+bool process_case_mode(uint16_t keycode, keyrecord_t* record);
+
+/** Starts typing an identifier in `mode`, or ends it with `CASE_MODE_OFF`. */
+void case_mode_on(case_mode_t mode);
+
+/** Ends the identifier. */
+void case_mode_off(void);
+
+/** The mode on, `CASE_MODE_OFF` if none. */
+case_mode_t case_mode_get(void);
+
+#else
+
+static inline bool process_case_mode(uint16_t keycode, keyrecord_t* record) {
+  return true;
+}
+static inline void case_mode_on(case_mode_t mode) {}
+static inline void case_mode_off(void) {}
+static inline case_mode_t case_mode_get(void) { return CASE_MODE_OFF; }
+
+#endif  // CASE_MODE_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
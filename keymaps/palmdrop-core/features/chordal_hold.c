@@ -0,0 +1,90 @@
+/**
+ * @file chordal_hold.c
+ * @brief Chordal hold implementation
+ */
+
+#include "chordal_hold.h"
+
+// The last mod-tap pressed, while no other key has been pressed after it.
+static bool pending = false;
+static keyrecord_t pending_record;
+
+// Mod-taps released early, whose physical release is swallowed.
+static matrix_row_t released_early[MATRIX_ROWS];
+static bool releasing = false;
+
+static char handedness(keypos_t key) {
+  if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+    return '*';
+  }
+  return pgm_read_byte(&chordal_hold_layout[key.row][key.col]);
+}
+
+bool get_chordal_hold_default(keyrecord_t* tap_hold_record,
+                              keyrecord_t* other_record) {
+  const char tap_hold_hand = handedness(tap_hold_record->event.key);
+  const char other_hand = handedness(other_record->event.key);
+  return tap_hold_hand == '*' || other_hand == '*' ||
+         tap_hold_hand != other_hand;
+}
+
+__attribute__((weak)) bool get_chordal_hold(uint16_t tap_hold_keycode,
+                                            keyrecord_t* tap_hold_record,
+                                            uint16_t other_keycode,
+                                            keyrecord_t* other_record) {
+  return get_chordal_hold_default(tap_hold_record, other_record);
+}
+
+bool process_chordal_hold(uint16_t keycode, keyrecord_t* record) {
+  if (record->event.type != KEY_EVENT || releasing) {
+    return true;
+  }
+  // Features before this one may have set the keycode, e.g. to a tap.
+  if (record->keycode) {
+    keycode = record->keycode;
+  }
+  const keypos_t key = record->event.key;
+  const matrix_row_t bit = (matrix_row_t)1 << key.col;
+
+  if (!record->event.pressed) {
+    if (released_early[key.row] & bit) {
+      released_early[key.row] &= ~bit;
+      return false;
+    }
+    if (pending && pending_record.event.key.row == key.row &&
+        pending_record.event.key.col == key.col) {
+      pending = false;
+    }
+    return true;
+  }
+
+  if (pending) {
+    // The first key pressed during the mod-tap settles it.
+    pending = false;
+    const uint16_t tap_hold_keycode = pending_record.keycode;
+    const uint16_t held_for = record->event.time - pending_record.event.time;
+    if (held_for < get_tapping_term(tap_hold_keycode, &pending_record) &&
+        !get_chordal_hold(tap_hold_keycode, &pending_record, keycode,
+                          record)) {
+      // Same hand: release the mod-tap before this key goes down, so that
+      // tapping settles it as a tap.
+      const keypos_t tap_hold_key = pending_record.event.key;
+      released_early[tap_hold_key.row] |= (matrix_row_t)1 << tap_hold_key.col;
+      releasing = true;
+      action_exec((keyevent_t){
+          .key = tap_hold_key,
+          .time = record->event.time,
+          .type = KEY_EVENT,
+          .pressed = false,
+      });
+      releasing = false;
+    }
+  }
+
+  if (IS_QK_MOD_TAP(keycode)) {
+    pending = true;
+    pending_record = *record;
+    pending_record.keycode = keycode;
+  }
+  return true;
+}
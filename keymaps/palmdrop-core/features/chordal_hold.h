@@ -0,0 +1,70 @@
+/**
+ * @file chordal_hold.h
+ * @brief Chordal hold: mod-taps only hold when chorded with the other hand.
+ *
+ * Home row mods misfire when a roll within one hand ends with the keys
+ * nested, and otherwise wait out the tapping term before typing. Modifiers
+ * are nearly always chorded with a key of the other hand, so here every key
+ * of the layout is labeled with its hand in `chordal_hold_layout`:
+ *
+ *     const char chordal_hold_layout[MATRIX_ROWS][MATRIX_COLS] PROGMEM =
+ *         LAYOUT_planck_grid(
+ *             'L', 'L', ..., 'R', 'R',
+ *             ...
+ *             'L', 'L', 'L', '*', '*', '*', '*', '*', '*', 'R', 'R', 'R');
+ *
+ * where '*' marks thumb keys, which go with either hand. When a key of the
+ * same hand is pressed while a mod-tap is still undecided, the mod-tap is
+ * settled as a tap right away, by releasing it early; its physical release
+ * is swallowed later. Keys of the other hand or thumbs leave the decision to
+ * tapping as before, with permissive hold and the tapping term.
+ *
+ * Define `get_chordal_hold()` to decide differently for some pairs of keys,
+ * e.g. keys of a combo. It returns whether the mod-tap may still be held.
+ *
+ * Call `process_chordal_hold()` from `pre_process_record_user()`, before
+ * features that hold back key events.
+ *
+ * Enable with `CHORDAL_HOLD_ENABLE = yes` in rules.mk.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Hand of each key: 'L', 'R', or '*' for thumbs. Define in keymap.c. */
+extern const char chordal_hold_layout[MATRIX_ROWS][MATRIX_COLS];
+
+/**
+ * Optional callback, whether the mod-tap `tap_hold_keycode` may still be
+ * held when `other_record` is pressed. The default is
+ * `get_chordal_hold_default()`.
+ */
+bool get_chordal_hold(uint16_t tap_hold_keycode, keyrecord_t* tap_hold_record,
+                      uint16_t other_keycode, keyrecord_t* other_record);
+
+/** Whether the keys are on opposite hands or either is a thumb key. */
+bool get_chordal_hold_default(keyrecord_t* tap_hold_record,
+                              keyrecord_t* other_record);
+
+#ifdef CHORDAL_HOLD_ENABLE
+
+/** Handler function for chordal hold. */
+bool process_chordal_hold(uint16_t keycode, keyrecord_t* record);
+
+#else
+
+static inline bool process_chordal_hold(uint16_t keycode,
+                                        keyrecord_t* record) {
+  return true;
+}
+
+#endif  // CHORDAL_HOLD_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
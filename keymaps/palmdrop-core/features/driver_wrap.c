@@ -0,0 +1,58 @@
+/**
+ * @file driver_wrap.c
+ * @brief Driver wrap implementation
+ */
+
+#include "driver_wrap.h"
+
+bool driver_wrap_keyboard(driver_wrap_t* wrap,
+                          void (*send_keyboard)(report_keyboard_t* report)) {
+  host_driver_t* current = host_get_driver();
+  if (!current || current == &wrap->driver ||
+      (wrap->wrapped && current != wrap->wrapped)) {
+    return false;
+  }
+  wrap->wrapped = current;
+  wrap->driver = *current;
+  wrap->send_keyboard = wrap->driver.send_keyboard;
+  wrap->driver.send_keyboard = send_keyboard;
+  host_set_driver(&wrap->driver);
+  return true;
+}
+
+static bool has_key(const report_keyboard_t* report, uint8_t keycode) {
+  for (uint8_t i = 0; i < sizeof(report->keys); ++i) {
+    if (report->keys[i] == keycode) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool driver_wrap_can_merge(const report_keyboard_t* sent,
+                           const report_keyboard_t* pending,
+                           const report_keyboard_t* report) {
+  bool key_pressed = false;
+  for (uint8_t i = 0; i < sizeof(pending->keys); ++i) {
+    const uint8_t keycode = pending->keys[i];
+    if (keycode != KC_NO && !has_key(sent, keycode)) {
+      if (!has_key(report, keycode)) {
+        return false;
+      }
+      key_pressed = true;
+    }
+  }
+  for (uint8_t i = 0; i < sizeof(sent->keys); ++i) {
+    const uint8_t keycode = sent->keys[i];
+    if (keycode != KC_NO && !has_key(pending, keycode) &&
+        has_key(report, keycode)) {
+      return false;
+    }
+  }
+  const uint8_t mods_pressed = pending->mods & ~sent->mods;
+  const uint8_t mods_released = sent->mods & ~pending->mods;
+  if ((mods_pressed & ~report->mods) || (mods_released & report->mods)) {
+    return false;
+  }
+  return !key_pressed || report->mods == pending->mods;
+}
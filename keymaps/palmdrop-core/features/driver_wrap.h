@@ -0,0 +1,61 @@
+/**
+ * @file driver_wrap.h
+ * @brief Driver wrap: `send_keyboard` of the QMK host driver wrapped.
+ *
+ * Features that watch or change keyboard reports put a function in front of
+ * the driver's `send_keyboard`. The driver is set up after
+ * `keyboard_post_init_user()`, so the wrap is installed lazily from a task:
+ *
+ *     static driver_wrap_t wrap;
+ *
+ *     static void send_keyboard(report_keyboard_t* report) {
+ *       // Look at the report...
+ *       wrap.send_keyboard(report);
+ *     }
+ *
+ *     void feature_task(void) {
+ *       driver_wrap_keyboard(&wrap, send_keyboard);
+ *     }
+ *
+ * The current driver is wrapped the first time there is one, and again if
+ * it's set back to the one wrapped. Another wrapper of it, set up later, is
+ * left alone, so wrappers stack in the order they were installed.
+ *
+ * Wrappers that hold a report back to merge the next ones into it ask
+ * `driver_wrap_can_merge()` whether the host would miss a change.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  host_driver_t driver;  // The driver with `send_keyboard` wrapped.
+  host_driver_t* wrapped;  // The driver it wraps, NULL until installed.
+  void (*send_keyboard)(report_keyboard_t* report);  // Of `wrapped`.
+} driver_wrap_t;
+
+/**
+ * Installs `send_keyboard` in front of the current driver if it isn't yet.
+ * Returns true when it was installed, false if nothing changed.
+ */
+bool driver_wrap_keyboard(driver_wrap_t* wrap,
+                          void (*send_keyboard)(report_keyboard_t* report));
+
+/**
+ * Whether `report` can replace `pending`, held back, without the host missing
+ * a change since `sent`: a key or mod pressed since is released again, one
+ * released since is pressed again, or mods change after a key was pressed,
+ * which would apply to that key.
+ */
+bool driver_wrap_can_merge(const report_keyboard_t* sent,
+                           const report_keyboard_t* pending,
+                           const report_keyboard_t* report);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,148 @@
+/**
+ * @file eager_debounce.c
+ * @brief Eager debounce implementation
+ */
+
+#include "eager_debounce.h"
+
+#include <string.h>
+
+#include "debounce.h"
+#include "latency_stats.h"
+
+#ifndef DEBOUNCE
+#define DEBOUNCE 5
+#endif  // DEBOUNCE
+
+#if DEBOUNCE > 127
+#error "eager_debounce: DEBOUNCE must be at most 127 ms"
+#endif
+
+// Set in a key's countdown while its release is deferred. Otherwise a running
+// countdown is the lockout after a press.
+#define RELEASE_PENDING 0x80
+#define COUNTDOWN_MASK 0x7F
+
+// clang-format off
+__attribute__((weak)) const uint8_t PROGMEM
+    debounce_times[MATRIX_ROWS][MATRIX_COLS] = {
+  [0 ... MATRIX_ROWS - 1] = {[0 ... MATRIX_COLS - 1] = DEBOUNCE},
+};
+// clang-format on
+
+// Ms left of every key's debounce window, 0 if the key is settled.
+static uint8_t countdown[MATRIX_ROWS][MATRIX_COLS];
+// Number of keys with a running countdown, so settled scans can return early.
+static uint8_t active = 0;
+static matrix_row_t last_raw[MATRIX_ROWS];
+static uint16_t last_time = 0;
+
+static uint16_t bounces[MATRIX_ROWS][MATRIX_COLS];
+// Shortest bounce in ms after the change it followed, 0xFF if none.
+static uint8_t shortest[MATRIX_ROWS][MATRIX_COLS];
+
+// Counts a bounce `interval` ms after the last accepted change of the key.
+static void count_bounce(uint8_t row, uint8_t col, uint8_t interval) {
+  if (bounces[row][col] < UINT16_MAX) {
+    ++bounces[row][col];
+  }
+  if (interval < shortest[row][col]) {
+    shortest[row][col] = interval;
+  }
+}
+
+void debounce_init(uint8_t num_rows) {
+  memset(countdown, 0, sizeof(countdown));
+  memset(last_raw, 0, sizeof(last_raw));
+  active = 0;
+  last_time = timer_read();
+  eager_debounce_reset();
+}
+
+void debounce_free(void) {}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows,
+              bool changed) {
+  if (!changed && !active) {
+    return false;
+  }
+  const uint16_t now = timer_read();
+  const uint16_t elapsed16 = now - last_time;
+  const uint8_t elapsed = elapsed16 > COUNTDOWN_MASK ? COUNTDOWN_MASK
+                                                     : elapsed16;
+  last_time = now;
+
+  bool cooked_changed = false;
+  for (uint8_t row = 0; row < num_rows; ++row) {
+    const matrix_row_t bounced = raw[row] ^ last_raw[row];
+    last_raw[row] = raw[row];
+    matrix_row_t cooked_row = cooked[row];
+    for (uint8_t col = 0; col < MATRIX_COLS; ++col) {
+      const matrix_row_t bit = (matrix_row_t)1 << col;
+      uint8_t* key = &countdown[row][col];
+      if (*key) {
+        const uint8_t left = *key & COUNTDOWN_MASK;
+        if (bounced & bit) {
+          const uint8_t time = pgm_read_byte(&debounce_times[row][col]);
+          count_bounce(row, col, time - left + elapsed);
+          if ((*key & RELEASE_PENDING) && (raw[row] & bit)) {
+            // Closed again before the release settled: not a release.
+            *key = 0;
+            --active;
+            continue;
+          }
+        }
+        if (left > elapsed) {
+          *key -= elapsed;
+          continue;
+        }
+        if (*key & RELEASE_PENDING) {
+          const uint8_t time = pgm_read_byte(&debounce_times[row][col]);
+          cooked_row &= ~bit;
+          latency_stats_debounced(row, col, false, time - left + elapsed);
+        }
+        *key = 0;
+        --active;
+        // A change during the press lockout is picked up below.
+      }
+      if ((raw[row] ^ cooked_row) & bit) {
+        const uint8_t time = pgm_read_byte(&debounce_times[row][col]);
+        if (time == 0) {
+          cooked_row ^= bit;
+          latency_stats_debounced(row, col, cooked_row & bit, 0);
+        } else if (raw[row] & bit) {
+          cooked_row |= bit;  // Eager press.
+          latency_stats_debounced(row, col, true, 0);
+          *key = time;
+          ++active;
+        } else {
+          *key = time | RELEASE_PENDING;  // Deferred release.
+          ++active;
+        }
+      }
+    }
+    if (cooked_row != cooked[row]) {
+      cooked[row] = cooked_row;
+      cooked_changed = true;
+    }
+  }
+  return cooked_changed;
+}
+
+void eager_debounce_reset(void) {
+  memset(bounces, 0, sizeof(bounces));
+  memset(shortest, 0xFF, sizeof(shortest));
+}
+
+void eager_debounce_print(void) {
+  uprintf("%-8s %8s %8s %8s\n", "key", "time", "bounces", "shortest");
+  for (uint8_t row = 0; row < MATRIX_ROWS; ++row) {
+    for (uint8_t col = 0; col < MATRIX_COLS; ++col) {
+      if (bounces[row][col]) {
+        uprintf("%u,%-6u %8u %8u %8u\n", row, col,
+                pgm_read_byte(&debounce_times[row][col]), bounces[row][col],
+                shortest[row][col]);
+      }
+    }
+  }
+}
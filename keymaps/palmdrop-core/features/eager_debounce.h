@@ -0,0 +1,58 @@
+/**
+ * @file eager_debounce.h
+ * @brief Eager debounce: per-key, eager on press, deferred on release.
+ *
+ * The default debounce delays every change until the key has been stable for
+ * `DEBOUNCE` ms, so every press reaches the keymap that much later. This
+ * custom debounce reports a press as soon as the matrix sees it and then
+ * ignores the key for its debounce time, while a release is only reported
+ * once the key has stayed released for its debounce time. Contacts bounce
+ * when they close and open, so chatter is caught either way, but presses
+ * are never delayed.
+ *
+ * The debounce time is per matrix position, defaulting to `DEBOUNCE` for all
+ * keys. To tune it, define the table in keymap.c on the visual grid:
+ *
+ *     const uint8_t PROGMEM debounce_times[MATRIX_ROWS][MATRIX_COLS] =
+ *         LAYOUT_planck_grid(5, 5, 5, ..., 12, 5);
+ *
+ * A time of 0 turns debouncing off for that key. Times are at most 127 ms.
+ *
+ * For every key, the number of bounces caught and the shortest time between
+ * an accepted change and a bounce are counted. Dump them with
+ * `eager_debounce_print()` to find the switches that actually chatter, and
+ * keep long debounce times only for those.
+ *
+ * Enable with `EAGER_DEBOUNCE_ENABLE = yes` in rules.mk, which replaces the
+ * QMK debounce algorithm (`DEBOUNCE_TYPE = custom`).
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef EAGER_DEBOUNCE_ENABLE
+
+/** Debounce time of every matrix position in ms, in PROGMEM. */
+extern const uint8_t debounce_times[MATRIX_ROWS][MATRIX_COLS];
+
+/** Prints the bounce statistics of the keys that bounced. */
+void eager_debounce_print(void);
+
+/** Clears the bounce statistics. */
+void eager_debounce_reset(void);
+
+#else
+
+static inline void eager_debounce_print(void) {}
+static inline void eager_debounce_reset(void) {}
+
+#endif  // EAGER_DEBOUNCE_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file eager_tap_dance.c
+ * @brief Eager tap dance implementation
+ */
+
+#include "eager_tap_dance.h"
+
+#include "scheduler.h"
+
+// The dance that a second press may still turn into a double tap.
+static const eager_tap_dance_t* active = NULL;
+static uint16_t active_keycode = KC_NO;
+static uint16_t press_time = 0;
+static scheduler_token_t finish_token = SCHEDULER_NO_TOKEN;
+
+// The action registered while the dance key is held.
+static bool held = false;
+static uint16_t registered = KC_NO;
+
+static void register_action(uint16_t keycode) {
+  registered = keycode;
+  register_code16(keycode);
+}
+
+// Ends the active dance, sending a deferred single tap action.
+static void finish(void) {
+  scheduler_cancel(finish_token);
+  finish_token = SCHEDULER_NO_TOKEN;
+  if (active && active->deferred) {
+    if (held) {
+      register_action(active->single);
+    } else {
+      tap_code16(active->single);
+    }
+  }
+  active = NULL;
+}
+
+static uint32_t eager_tap_dance_timeout(uint32_t now, void* arg) {
+  finish_token = SCHEDULER_NO_TOKEN;
+  finish();
+  return 0;
+}
+
+bool eager_tap_dance_active(void) { return active != NULL; }
+
+bool process_eager_tap_dance(uint16_t keycode, keyrecord_t* record) {
+  if (!IS_QK_TAP_DANCE(keycode)) {
+    if (active && record->event.pressed) {
+      finish();  // Interrupted by another key.
+    }
+    return true;
+  }
+
+  if (!record->event.pressed) {
+    held = false;
+    if (registered != KC_NO) {
+      unregister_code16(registered);
+      registered = KC_NO;
+    }
+    return false;
+  }
+
+  const uint16_t time = record->event.time;
+  const uint16_t term = get_tapping_term(keycode, record);
+  if (active && keycode == active_keycode &&
+      (uint16_t)(time - press_time) < term) {
+    // Second tap: the double tap action, and the dance is over.
+    scheduler_cancel(finish_token);
+    finish_token = SCHEDULER_NO_TOKEN;
+    if (active->undo != KC_NO) {
+      tap_code16(active->undo);
+    }
+    held = true;
+    register_action(active->double_tap);
+    active = NULL;
+    return false;
+  }
+
+  if (active) {
+    finish();  // A different dance, or the term ran out.
+  }
+  active = &eager_tap_dances[QK_TAP_DANCE_GET_INDEX(keycode)];
+  active_keycode = keycode;
+  press_time = time;
+  held = true;
+  if (active->deferred) {
+    finish_token = scheduler_defer(term, eager_tap_dance_timeout, NULL);
+  } else {
+    register_action(active->single);
+  }
+  return false;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file eager_tap_dance.h
+ * @brief Eager tap dance: the single tap action goes out on the first press.
+ *
+ * QMK's tap dance waits out the tapping term after a tap before it knows
+ * whether a second tap follows, so a single tap, usually the common case,
+ * always lags by the term. Here the single tap action is registered right
+ * away on press, and a second press within the term sends the double tap
+ * action instead, optionally after tapping a keycode that undoes the first:
+ *
+ *     const eager_tap_dance_t eager_tap_dances[] = {
+ *       // End, or Home when double tapped. Home makes End moot.
+ *       [TD_GG] = EAGER_TAP_DANCE_DOUBLE(KC_END, KC_HOME),
+ *       // A dot, or a colon replacing it when double tapped.
+ *       [TD_DOT] = EAGER_TAP_DANCE_UNDO(KC_DOT, KC_BSPC, KC_COLN),
+ *       // Actions that can't be taken back wait like QMK's tap dance.
+ *       [TD_MEDIA] = EAGER_TAP_DANCE_DEFERRED(KC_MPLY, KC_MNXT),
+ *     };
+ *
+ * used with the `TD(index)` keycodes in the keymap. Deferred dances send the
+ * single tap action once the term runs out or another key is pressed, or
+ * hold it if the key is still down.
+ *
+ * Call `process_eager_tap_dance()` from `process_record_user()`. Deferred
+ * dances run on the scheduler (features/scheduler.h).
+ *
+ * Enable with `EAGER_TAP_DANCE_ENABLE = yes` in rules.mk, instead of
+ * `TAP_DANCE_ENABLE`.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  uint16_t single;      // Sent on the first press.
+  uint16_t double_tap;  // Sent on a second press within the term.
+  uint16_t undo;        // Tapped before `double_tap`, KC_NO for none.
+  bool deferred;        // `single` waits until no second tap can follow.
+} eager_tap_dance_t;
+
+#define EAGER_TAP_DANCE_DOUBLE(kc_single, kc_double) \
+  { .single = (kc_single), .double_tap = (kc_double) }
+#define EAGER_TAP_DANCE_UNDO(kc_single, kc_undo, kc_double) \
+  { .single = (kc_single), .double_tap = (kc_double), .undo = (kc_undo) }
+#define EAGER_TAP_DANCE_DEFERRED(kc_single, kc_double) \
+  { .single = (kc_single), .double_tap = (kc_double), .deferred = true }
+
+/** Dances of the `TD(index)` keycodes. Define in keymap.c. */
+extern const eager_tap_dance_t eager_tap_dances[];
+
+#ifdef EAGER_TAP_DANCE_ENABLE
+
+/** Handler function for eager tap dance. */
+bool process_eager_tap_dance(uint16_t keycode, keyrecord_t* record);
+
+/** Whether a dance may still turn into a double tap. */
+bool eager_tap_dance_active(void);
+
+#else
+
+static inline bool process_eager_tap_dance(uint16_t keycode,
+                                           keyrecord_t* record) {
+  return true;
+}
+static inline bool eager_tap_dance_active(void) { return false; }
+
+#endif  // EAGER_TAP_DANCE_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file feature_chain.c
+ * @brief Feature chain implementation
+ */
+
+#include "feature_chain.h"
+
+#include "pipeline_profile.h"
+
+#if FEATURE_CHAIN_MAX > 16
+#error "feature_chain: FEATURE_CHAIN_MAX is at most 16"
+#endif
+
+// Features handling each class, a bit per feature index, always and while
+// they're active.
+static uint16_t always[NUM_KEYCODE_CLASSES];
+static uint16_t while_active[NUM_KEYCODE_CLASSES];
+
+void feature_chain_init(void) {
+  for (uint8_t class = 0; class < NUM_KEYCODE_CLASSES; ++class) {
+    always[class] = while_active[class] = 0;
+  }
+  for (uint8_t i = 0; i < features_count && i < FEATURE_CHAIN_MAX; ++i) {
+    const keycode_classes_t classes = pgm_read_byte(&features[i].classes);
+    const keycode_classes_t active_classes =
+        pgm_read_ptr(&features[i].active)
+            ? pgm_read_byte(&features[i].active_classes) & ~classes
+            : 0;
+    for (uint8_t class = 0; class < NUM_KEYCODE_CLASSES; ++class) {
+      if (classes & (1 << class)) {
+        always[class] |= (uint16_t)1 << i;
+      } else if (active_classes & (1 << class)) {
+        while_active[class] |= (uint16_t)1 << i;
+      }
+    }
+  }
+}
+
+bool feature_chain_process(uint16_t keycode, keyrecord_t* record) {
+  const uint8_t class = keycode_class(keycode);
+  const uint16_t needs_active = while_active[class];
+  uint16_t remaining = always[class] | needs_active;
+  while (remaining) {
+    const uint8_t i = __builtin_ctz(remaining);
+    const uint16_t bit = (uint16_t)1 << i;
+    remaining &= ~bit;
+    if (needs_active & bit) {
+      bool (*active)(void) = pgm_read_ptr(&features[i].active);
+      if (!active()) {
+        continue;
+      }
+    }
+    bool (*process)(uint16_t, keyrecord_t*) = pgm_read_ptr(&features[i].process);
+    const bool handled = !process(keycode, record);
+    pipeline_profile_stage(i);
+    if (handled) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const char* feature_chain_name(uint8_t index) {
+  return index < features_count ? pgm_read_ptr(&features[index].name) : "?";
+}
@@ -0,0 +1,77 @@
+/**
+ * @file feature_chain.h
+ * @brief Feature chain: `process_record_user()` features that only see the
+ * keycodes they handle.
+ *
+ * Calling every feature's handler in turn made each event go through all of
+ * them, even those turned off or that return true right away for its
+ * keycode. Here features are listed in the order they run, each with the
+ * keycode classes (features/keycode_class.h) it always handles and the ones
+ * it handles while it's active:
+ *
+ *     const feature_t PROGMEM features[] = {
+ *       FEATURE("leader", process_leader_trie, KEYCODE_CLASSES(QUANTUM),
+ *               leader_trie_active, KEYCODE_CLASSES_ALL),
+ *       FEATURE_ALWAYS("keycodes", process_keycodes, KEYCODE_CLASSES(USER)),
+ *     };
+ *     const uint8_t features_count = sizeof(features) / sizeof(features[0]);
+ *
+ * A feature must return true, and change nothing, for events of a class it
+ * doesn't list, and for those it only lists while active when `active()`
+ * returns false.
+ *
+ * `feature_chain_init()` builds two bitmaps of features per class, the ones
+ * that always handle it and the ones that do while active.
+ * `feature_chain_process()` looks up the event's class and calls the handlers
+ * of the first bitmap, and of the second whose `active()` returns true, in
+ * order, until one returns false. With the pipeline profile enabled every
+ * handler called closes its stage, numbered by its index, so the profile
+ * counts how many events reach each feature and what they cost per class.
+ *
+ * Call `feature_chain_init()` from `keyboard_post_init_user()` and
+ * `feature_chain_process()` from `process_record_user()`.
+ */
+
+#pragma once
+
+#include "quantum.h"
+#include "keycode_class.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Most features in the chain.
+#ifndef FEATURE_CHAIN_MAX
+#define FEATURE_CHAIN_MAX 16
+#endif  // FEATURE_CHAIN_MAX
+
+typedef struct {
+  const char* name;
+  bool (*process)(uint16_t keycode, keyrecord_t* record);
+  bool (*active)(void);  // NULL if the feature is always active.
+  keycode_classes_t classes;
+  keycode_classes_t active_classes;
+} feature_t;
+
+#define FEATURE(name, process, classes, active, active_classes) \
+  { (name), (process), (active), (classes), (active_classes) }
+#define FEATURE_ALWAYS(name, process, classes) \
+  FEATURE(name, process, classes, NULL, KEYCODE_CLASSES_NONE)
+
+/** Features in the order they run. Define in keymap.c. */
+extern const feature_t features[];
+extern const uint8_t features_count;
+
+/** Builds the bitmaps of features per keycode class. */
+void feature_chain_init(void);
+
+/** Runs the features that handle `keycode`, returns false if one did. */
+bool feature_chain_process(uint16_t keycode, keyrecord_t* record);
+
+/** Name of the feature at `index`, for the pipeline profile. */
+const char* feature_chain_name(uint8_t index);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file keycode_cache.c
+ * @brief Keycode cache implementation
+ */
+
+#include "keycode_cache.h"
+
+#include <string.h>
+
+#if !defined(REPEAT_KEY_ENABLE) && !defined(COMBO_ENABLE)
+#error "keycode_cache: needs REPEAT_KEY_ENABLE or COMBO_ENABLE"
+#endif
+
+// Layer of keys that are transparent on all active layers.
+#define NO_LAYER -1
+
+// Layers the cache was resolved under, layer 0 is always among them since
+// QMK falls back to it.
+static layer_state_t cached_state = 0;
+static uint16_t cached_keycodes[MATRIX_ROWS][MATRIX_COLS];
+static int8_t cached_layers[MATRIX_ROWS][MATRIX_COLS];
+
+// Keycodes of held keys as they were pressed, and the keys whose records got
+// theirs from the cache.
+static uint16_t pressed_keycodes[MATRIX_ROWS][MATRIX_COLS];
+static matrix_row_t applied[MATRIX_ROWS];
+// Held layer-taps whose layer isn't on, so may still be turned on.
+static matrix_row_t layer_taps[MATRIX_ROWS];
+static uint8_t num_layer_taps = 0;
+
+// Resolves `key` from the highest of `layers` down to `lowest`, leaving the
+// cache as it is if all of them are transparent.
+static void resolve(keypos_t key, layer_state_t layers, int8_t lowest) {
+  for (int8_t layer = get_highest_layer(layers); layer >= lowest; --layer) {
+    if (layers & ((layer_state_t)1 << layer)) {
+      const uint16_t keycode = keymap_key_to_keycode(layer, key);
+      if (keycode != KC_TRNS) {
+        cached_keycodes[key.row][key.col] = keycode;
+        cached_layers[key.row][key.col] = layer;
+        return;
+      }
+    }
+  }
+}
+
+static void update(layer_state_t state) {
+  state |= 1;
+  if (state == cached_state) {
+    return;
+  }
+  const layer_state_t turned_off = cached_state & ~state;
+  const layer_state_t turned_on = state & ~cached_state;
+  keypos_t key;
+  for (key.row = 0; key.row < MATRIX_ROWS; ++key.row) {
+    for (key.col = 0; key.col < MATRIX_COLS; ++key.col) {
+      const int8_t layer = cached_layers[key.row][key.col];
+      if (!cached_state ||
+          (layer != NO_LAYER && (turned_off & ((layer_state_t)1 << layer)))) {
+        cached_keycodes[key.row][key.col] = KC_TRNS;
+        cached_layers[key.row][key.col] = NO_LAYER;
+        resolve(key, state, 0);
+      } else if (turned_on) {
+        resolve(key, turned_on, layer + 1);
+      }
+    }
+  }
+  cached_state = state;
+}
+
+// Drops the held layer-taps whose layer `state` turns on.
+static void settle_layer_taps(layer_state_t state) {
+  for (uint8_t row = 0; num_layer_taps && row < MATRIX_ROWS; ++row) {
+    for (uint8_t col = 0; layer_taps[row] && col < MATRIX_COLS; ++col) {
+      const matrix_row_t bit = (matrix_row_t)1 << col;
+      const uint8_t layer =
+          QK_LAYER_TAP_GET_LAYER(pressed_keycodes[row][col]);
+      if ((layer_taps[row] & bit) && (state & ((layer_state_t)1 << layer))) {
+        layer_taps[row] &= ~bit;
+        --num_layer_taps;
+      }
+    }
+  }
+}
+
+void keycode_cache_init(void) {
+  cached_state = 0;
+  update(layer_state | default_layer_state);
+  memset(applied, 0, sizeof(applied));
+  memset(layer_taps, 0, sizeof(layer_taps));
+  num_layer_taps = 0;
+}
+
+layer_state_t keycode_cache_layer_state_set(layer_state_t state) {
+  update(state | default_layer_state);
+  settle_layer_taps(state | default_layer_state);
+  return state;
+}
+
+void keycode_cache_pre_process(keyrecord_t* record) {
+  const keypos_t key = record->event.key;
+  if (record->event.type != KEY_EVENT || record->keycode ||
+      key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+    return;
+  }
+  const matrix_row_t bit = (matrix_row_t)1 << key.col;
+
+  if (!record->event.pressed) {
+    if (applied[key.row] & bit) {
+      record->keycode = pressed_keycodes[key.row][key.col];
+    }
+    if (layer_taps[key.row] & bit) {
+      --num_layer_taps;
+    }
+    applied[key.row] &= ~bit;
+    layer_taps[key.row] &= ~bit;
+    return;
+  }
+
+  // Catches default layer changes, which don't go through
+  // layer_state_set_user().
+  update(layer_state | default_layer_state);
+  const uint16_t keycode = keycode_cache_get(key);
+  pressed_keycodes[key.row][key.col] = keycode;
+  if (!num_layer_taps) {
+    record->keycode = keycode;
+    applied[key.row] |= bit;
+  }
+  if (IS_QK_LAYER_TAP(keycode) &&
+      !(cached_state & ((layer_state_t)1 << QK_LAYER_TAP_GET_LAYER(keycode)))) {
+    layer_taps[key.row] |= bit;
+    ++num_layer_taps;
+  }
+}
+
+uint16_t keycode_cache_get(keypos_t key) {
+  const uint16_t keycode = cached_keycodes[key.row][key.col];
+  return keycode != KC_TRNS ? keycode : KC_NO;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file keycode_cache.h
+ * @brief Keycode cache: the keymap resolved under the active layers, in RAM.
+ *
+ * Most of the keymap is transparent, so QMK walks down the layer stack
+ * reading flash until a layer has the key, and does so again in each stage
+ * an event goes through: pre-processing, tapping, `process_record()` and the
+ * action lookup. Here the keycode each key resolves to, and the layer it
+ * comes from, are kept in RAM for the current layer state, and rebuilt when
+ * layers change, only where that can matter:
+ *
+ *   - keys that came from a layer turned off are resolved again,
+ *   - keys below a layer turned on read that layer only.
+ *
+ * `keycode_cache_pre_process()` sets the cached keycode as the record's
+ * keycode, which QMK uses instead of walking the layers from then on. The
+ * release gets the keycode the press had. A press while a layer-tap is held
+ * whose layer isn't on yet is left to QMK, since it's queued until the
+ * layer-tap settles and must see the layer it may turn on.
+ *
+ * Call `keycode_cache_init()` from `keyboard_post_init_user()`,
+ * `keycode_cache_layer_state_set()` from `layer_state_set_user()` with the
+ * state it returns, and `keycode_cache_pre_process()` first thing in
+ * `pre_process_record_user()`. `keycode_cache_get()` is the keycode a key
+ * would send now, a single array read.
+ *
+ * Enable with `KEYCODE_CACHE_ENABLE = yes` in rules.mk. Needs
+ * `REPEAT_KEY_ENABLE` or `COMBO_ENABLE`, which give records the keycode
+ * field that overrides the keymap.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef KEYCODE_CACHE_ENABLE
+
+/** Resolves every key under the current layers. */
+void keycode_cache_init(void);
+
+/** Brings the cache up to date with `state`, and returns it. */
+layer_state_t keycode_cache_layer_state_set(layer_state_t state);
+
+/** Sets the cached keycode on `record` where QMK would resolve the same. */
+void keycode_cache_pre_process(keyrecord_t* record);
+
+/** The keycode `key` resolves to under the active layers. */
+uint16_t keycode_cache_get(keypos_t key);
+
+#else
+
+static inline void keycode_cache_init(void) {}
+static inline layer_state_t keycode_cache_layer_state_set(
+    layer_state_t state) {
+  return state;
+}
+static inline void keycode_cache_pre_process(keyrecord_t* record) {}
+
+#endif  // KEYCODE_CACHE_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,58 @@
+/**
+ * @file keycode_class.h
+ * @brief Keycode classes: keycodes grouped by the range they fall in.
+ *
+ * Eight classes, so a set of them fits a byte. The pipeline profile breaks
+ * its totals down by class, and the feature chain skips features that don't
+ * handle a class (features/feature_chain.h).
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+  KEYCODE_CLASS_ALPHA,      /**< KC_A ... KC_Z */
+  KEYCODE_CLASS_BASIC,      /**< Other basic keycodes. */
+  KEYCODE_CLASS_MODS,       /**< Modified keycodes like LCTL(KC_C) and SE_* symbols. */
+  KEYCODE_CLASS_MOD_TAP,    /**< Mod-taps, e.g. home row mods. */
+  KEYCODE_CLASS_LAYER_TAP,  /**< Layer-taps. */
+  KEYCODE_CLASS_LAYER,      /**< Other layer keys: MO, TO, TG, OSL, OSM, LM, TT. */
+  KEYCODE_CLASS_QUANTUM,    /**< Other QMK keycodes (leader, repeat, macros, ...). */
+  KEYCODE_CLASS_USER,       /**< Keymap custom keycodes. */
+  NUM_KEYCODE_CLASSES,
+};
+
+/** Set of keycode classes, a bit per class. */
+typedef uint8_t keycode_classes_t;
+
+#define KEYCODE_CLASSES(class) ((keycode_classes_t)1 << KEYCODE_CLASS_##class)
+#define KEYCODE_CLASSES_NONE ((keycode_classes_t)0)
+#define KEYCODE_CLASSES_ALL ((keycode_classes_t)0xFF)
+
+static inline uint8_t keycode_class(uint16_t keycode) {
+  if (keycode >= KC_A && keycode <= KC_Z) {
+    return KEYCODE_CLASS_ALPHA;
+  } else if (IS_QK_BASIC(keycode)) {
+    return KEYCODE_CLASS_BASIC;
+  } else if (IS_QK_MODS(keycode)) {
+    return KEYCODE_CLASS_MODS;
+  } else if (IS_QK_MOD_TAP(keycode)) {
+    return KEYCODE_CLASS_MOD_TAP;
+  } else if (IS_QK_LAYER_TAP(keycode)) {
+    return KEYCODE_CLASS_LAYER_TAP;
+  } else if (keycode >= QK_LAYER_MOD && keycode <= QK_LAYER_TAP_TOGGLE_MAX) {
+    return KEYCODE_CLASS_LAYER;
+  } else if (keycode >= QK_USER) {
+    return KEYCODE_CLASS_USER;
+  }
+  return KEYCODE_CLASS_QUANTUM;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,191 @@
+/**
+ * @file latency_stats.c
+ * @brief Latency stats implementation
+ */
+
+#include "latency_stats.h"
+
+#include <string.h>
+
+#include "driver_wrap.h"
+#include "leader_trie.h"
+
+#ifndef COMBO_TERM
+#define COMBO_TERM 50
+#endif  // COMBO_TERM
+
+// Buckets 0 ms, 1 ms, 2-3 ms, 4-7 ms, ... 512 ms and more.
+#define HISTOGRAM_SIZE 11
+#define SCAN_RATE_WINDOW 1000
+
+typedef struct {
+  uint32_t count;
+  uint32_t sum;
+  uint16_t max;
+  uint16_t histogram[HISTOGRAM_SIZE];
+} latency_stat_t;
+
+static latency_stat_t total_stats;
+static latency_stat_t cause_stats[LATENCY_NUM_CAUSES];
+
+// Debounce delay of the last release and press of every key. A tap-hold
+// key's press can reach process_record_user after its release was debounced.
+static uint8_t debounce_delay[2][MATRIX_ROWS][MATRIX_COLS];
+
+// The event waiting for its report, and the waits it went through so far.
+static bool pending = false;
+static uint16_t pending_start = 0;  // Matrix change.
+static uint16_t pending_waits[LATENCY_NUM_CAUSES];
+
+#if defined(LEADER_ENABLE) || defined(LEADER_TRIE_ENABLE)
+// Last key of the running leader sequence, reported when the sequence ends.
+static bool leader_pending = false;
+static uint16_t leader_start = 0;
+
+static bool leader_active(void) {
+#ifdef LEADER_TRIE_ENABLE
+  return leader_trie_active();
+#else
+  return leader_sequence_active();
+#endif  // LEADER_TRIE_ENABLE
+}
+#endif  // LEADER_ENABLE || LEADER_TRIE_ENABLE
+
+// Scans in the current window, and scans per second of the finished ones.
+static uint16_t scans = 0;
+static uint16_t scan_window_start = 0;
+static uint16_t scan_rate = 0;
+static uint16_t scan_rate_min = UINT16_MAX;
+static uint16_t scan_rate_max = 0;
+
+static driver_wrap_t wrap;
+
+static void stat_add(latency_stat_t* stat, uint16_t value) {
+  ++stat->count;
+  stat->sum += value;
+  if (value > stat->max) {
+    stat->max = value;
+  }
+  const uint8_t bucket = value ? 32 - __builtin_clz(value) : 0;
+  uint16_t* bin =
+      &stat->histogram[bucket < HISTOGRAM_SIZE ? bucket : HISTOGRAM_SIZE - 1];
+  if (*bin < UINT16_MAX) {
+    ++*bin;
+  }
+}
+
+static void send_keyboard(report_keyboard_t* report) {
+  wrap.send_keyboard(report);
+  const uint16_t now = timer_read();
+#if defined(LEADER_ENABLE) || defined(LEADER_TRIE_ENABLE)
+  if (leader_pending && !leader_active()) {
+    // First report of the sequence's action.
+    leader_pending = false;
+    stat_add(&total_stats, now - leader_start);
+    stat_add(&cause_stats[LATENCY_LEADER], now - leader_start);
+    return;
+  }
+#endif  // LEADER_ENABLE || LEADER_TRIE_ENABLE
+  if (!pending) {
+    return;
+  }
+  pending = false;
+
+  uint8_t cause = LATENCY_NONE;
+  for (uint8_t i = LATENCY_NONE + 1; i < LATENCY_NUM_CAUSES; ++i) {
+    if (pending_waits[i] > pending_waits[cause]) {
+      cause = i;
+    }
+  }
+  const uint16_t latency = now - pending_start;
+  stat_add(&total_stats, latency);
+  stat_add(&cause_stats[cause], latency);
+}
+
+void latency_stats_task(void) {
+  driver_wrap_keyboard(&wrap, send_keyboard);
+
+  ++scans;
+  const uint16_t elapsed = timer_elapsed(scan_window_start);
+  if (elapsed >= SCAN_RATE_WINDOW) {
+    scan_rate = (uint32_t)scans * 1000 / elapsed;
+    if (scan_rate < scan_rate_min) {
+      scan_rate_min = scan_rate;
+    }
+    if (scan_rate > scan_rate_max) {
+      scan_rate_max = scan_rate;
+    }
+    scans = 0;
+    scan_window_start += elapsed;
+  }
+}
+
+void latency_stats_debounced(uint8_t row, uint8_t col, bool pressed,
+                             uint8_t delay) {
+  debounce_delay[pressed][row][col] = delay;
+}
+
+__attribute__((weak)) bool latency_stats_combo_key(keypos_t key) {
+  return false;
+}
+
+void latency_stats_record(uint16_t keycode, keyrecord_t* record) {
+  const uint16_t now = timer_read();
+  const uint16_t wait = now - record->event.time;
+  const keypos_t key = record->event.key;
+
+  memset(pending_waits, 0, sizeof(pending_waits));
+  if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+    pending_waits[LATENCY_DEBOUNCE] =
+        debounce_delay[record->event.pressed][key.row][key.col];
+  }
+  if (record->event.type == COMBO_EVENT) {
+    pending_waits[LATENCY_COMBO] = wait;
+  } else if (latency_stats_combo_key(key)) {
+    pending_waits[LATENCY_COMBO] = wait < COMBO_TERM ? wait : COMBO_TERM;
+  }
+  pending_waits[LATENCY_TAPPING] = wait - pending_waits[LATENCY_COMBO];
+  pending_start = record->event.time - pending_waits[LATENCY_DEBOUNCE];
+#if defined(LEADER_ENABLE) || defined(LEADER_TRIE_ENABLE)
+  if (leader_active() && record->event.pressed) {
+    // Consumed by the sequence, whose output comes when it times out.
+    leader_pending = true;
+    leader_start = pending_start;
+    return;
+  }
+#endif  // LEADER_ENABLE || LEADER_TRIE_ENABLE
+  pending = true;
+}
+
+void latency_stats_reset(void) {
+  memset(&total_stats, 0, sizeof(total_stats));
+  memset(cause_stats, 0, sizeof(cause_stats));
+  scan_rate_min = UINT16_MAX;
+  scan_rate_max = 0;
+}
+
+static void print_stat(const char* name, const latency_stat_t* stat) {
+  if (stat->count == 0) {
+    return;
+  }
+  uprintf("%-9s %6lu %4lu %4u", name, (unsigned long)stat->count,
+          (unsigned long)(stat->sum / stat->count), stat->max);
+  for (uint8_t i = 0; i < HISTOGRAM_SIZE; ++i) {
+    uprintf(" %4u", stat->histogram[i]);
+  }
+  uprintf("\n");
+}
+
+void latency_stats_print(void) {
+  static const char* const cause_names[LATENCY_NUM_CAUSES] = {
+      "none", "debounce", "tapping", "combo", "leader",
+  };
+  uprintf("scans/s %u min %u max %u\n", scan_rate,
+          scan_rate_max ? scan_rate_min : 0, scan_rate_max);
+  uprintf("%-9s %6s %4s %4s    0    1    2    4    8   16   32   64  128  256"
+          "  512\n", "ms", "count", "avg", "max");
+  print_stat("all", &total_stats);
+  for (uint8_t i = 0; i < LATENCY_NUM_CAUSES; ++i) {
+    print_stat(cause_names[i], &cause_stats[i]);
+  }
+}
@@ -0,0 +1,94 @@
+/**
+ * @file latency_stats.h
+ * @brief Latency stats: matrix scan rate and press-to-report latency.
+ *
+ * Counts matrix scans per second, and measures for every key event how long
+ * it takes from the matrix change to the HID report that carries it. Each
+ * event's latency is split into the waits it went through:
+ *
+ *  * debounce: the time the debounce held the change back (needs
+ *    `EAGER_DEBOUNCE_ENABLE`, which reports it),
+ *  * combo: the time the key was held back by the combo term, for combo
+ *    events and keys that are part of a combo,
+ *  * tapping: the rest of the time before the record reached
+ *    `process_record_user()`, i.e. waiting for a tap-hold key to settle,
+ *  * leader: for the last key of a leader sequence, the time until the first
+ *    report of its action (QMK's leader or features/leader_trie.h).
+ *
+ * and the latency is added to a histogram for the largest of them ("none" if
+ * the event went out in the same millisecond), as well as to the total. The
+ * histograms have one bucket per power of two milliseconds.
+ *
+ * Reports are observed by wrapping `send_keyboard` of the QMK host driver, so
+ * only 6KRO keyboard reports are measured. An event is matched to the first
+ * report after it reached `process_record_user()`; events that don't change
+ * the report (e.g. layer keys) are matched to the next report, so look at
+ * the histograms of keys you typed rather than at the maximum.
+ *
+ * Call `latency_stats_task()` from `matrix_scan_user()` and
+ * `latency_stats_record()` first thing in `process_record_user()`, and dump
+ * the tables with `latency_stats_print()`.
+ *
+ * Enable with `LATENCY_STATS_ENABLE = yes` in rules.mk. When disabled, all
+ * functions compile to nothing.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Waits a key event's latency is attributed to. */
+enum latency_cause {
+  LATENCY_NONE,
+  LATENCY_DEBOUNCE,
+  LATENCY_TAPPING,
+  LATENCY_COMBO,
+  LATENCY_LEADER,
+  LATENCY_NUM_CAUSES,
+};
+
+#ifdef LATENCY_STATS_ENABLE
+
+/** Counts a matrix scan. Call from `matrix_scan_user()`. */
+void latency_stats_task(void);
+
+/** Starts timing a key event. Call from `process_record_user()`. */
+void latency_stats_record(uint16_t keycode, keyrecord_t* record);
+
+/** Called by the debounce when it lets a change through `delay` ms late. */
+void latency_stats_debounced(uint8_t row, uint8_t col, bool pressed,
+                             uint8_t delay);
+
+/** Prints the scan rate and latency histograms to the console. */
+void latency_stats_print(void);
+
+/** Clears all collected statistics. */
+void latency_stats_reset(void);
+
+/**
+ * Optional callback, whether the key at `key` is part of a combo.
+ *
+ * Used to attribute waits of up to `COMBO_TERM` to combos. The default
+ * returns false.
+ */
+bool latency_stats_combo_key(keypos_t key);
+
+#else
+
+static inline void latency_stats_task(void) {}
+static inline void latency_stats_record(uint16_t keycode,
+                                        keyrecord_t* record) {}
+static inline void latency_stats_debounced(uint8_t row, uint8_t col,
+                                           bool pressed, uint8_t delay) {}
+static inline void latency_stats_print(void) {}
+static inline void latency_stats_reset(void) {}
+
+#endif  // LATENCY_STATS_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
@@ -22,19 +22,28 @@
 
 #include "layer_lock.h"
 
+#include "scheduler.h"
+
 // The current lock state. The kth bit is on if layer k is locked.
 static layer_state_t locked_layers = 0;
 
-// Layer Lock timer to disable layer lock after X seconds inactivity
+// Layer Lock timer to disable layer lock after X seconds inactivity. Key
+// presses only update the timer, the idle callback reschedules itself until
+// the timeout has passed since the last press.
 #if LAYER_LOCK_IDLE_TIMEOUT > 0
 static uint32_t layer_lock_timer = 0;
+static scheduler_token_t idle_token = SCHEDULER_NO_TOKEN;
 
-void layer_lock_task(void) {
-  if (locked_layers &&
-      timer_elapsed32(layer_lock_timer) > LAYER_LOCK_IDLE_TIMEOUT) {
+static uint32_t layer_lock_idle(uint32_t now, void* arg) {
+  const uint32_t idle = now - layer_lock_timer;
+  if (locked_layers && idle < LAYER_LOCK_IDLE_TIMEOUT) {
+    return LAYER_LOCK_IDLE_TIMEOUT - idle;
+  }
+  idle_token = SCHEDULER_NO_TOKEN;
+  if (locked_layers) {
     layer_lock_all_off();
-    layer_lock_timer = timer_read32();
   }
+  return 0;
 }
 #endif  // LAYER_LOCK_IDLE_TIMEOUT > 0
 
@@ -106,6 +115,8 @@ bool is_layer_locked(uint8_t layer) {
   return locked_layers & ((layer_state_t)1 << layer);
 }
 
+bool layer_lock_active(void) { return locked_layers != 0; }
+
 void layer_lock_invert(uint8_t layer) {
   const layer_state_t mask = (layer_state_t)1 << layer;
   if ((locked_layers & mask) == 0) {  // Layer is being locked.
@@ -117,6 +128,10 @@ void layer_lock_invert(uint8_t layer) {
     layer_on(layer);
 #if LAYER_LOCK_IDLE_TIMEOUT > 0
     layer_lock_timer = timer_read32();
+    if (idle_token == SCHEDULER_NO_TOKEN) {
+      idle_token =
+          scheduler_defer(LAYER_LOCK_IDLE_TIMEOUT, layer_lock_idle, NULL);
+    }
 #endif  // LAYER_LOCK_IDLE_TIMEOUT > 0
   } else {  // Layer is being unlocked.
     layer_off(layer);
@@ -49,10 +49,12 @@
  *
  *     #define LAYER_LOCK_IDLE_TIMEOUT 60000  // Turn off after 60 seconds.
  *
- * and call `layer_lock_task()` from your `matrix_scan_user()` in keymap.c:
+ * The timeout runs on the scheduler (features/scheduler.h), so add
+ * `features/scheduler.c` to your rules.mk and call `scheduler_task()` from
+ * your `matrix_scan_user()` in keymap.c:
  *
  *     void matrix_scan_user(void) {
- *       layer_lock_task();
+ *       scheduler_task();
  *       // Other tasks...
  *     }
  *
@@ -90,6 +92,9 @@ bool process_layer_lock(uint16_t keycode, keyrecord_t* record,
 /** Returns true if `layer` is currently locked. */
 bool is_layer_locked(uint8_t layer);
 
+/** Returns true if any layer is locked. */
+bool layer_lock_active(void);
+
 /** Locks and turns on `layer`. */
 void layer_lock_on(uint8_t layer);
 
@@ -117,20 +122,6 @@ void layer_lock_invert(uint8_t layer);
  */
 void layer_lock_set_user(layer_state_t locked_layers);
 
-/**
- * @fn layer_lock_task(void)
- * Matrix task function for Layer Lock.
- *
- * If using `LAYER_LOCK_IDLE_TIMEOUT`, call this function from your
- * `matrix_scan_user()` function in keymap.c. (If no timeout is set, calling
- * `layer_lock_task()` has no effect.)
- */
-#if LAYER_LOCK_IDLE_TIMEOUT > 0
-void layer_lock_task(void);
-#else
-static inline void layer_lock_task(void) {}
-#endif  // LAYER_LOCK_IDLE_TIMEOUT > 0
-
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,170 @@
+/**
+ * @file leader_trie.c
+ * @brief Leader trie implementation
+ */
+
+#define LEADER_TRIE_TABLES
+#include "leader_trie.h"
+
+#include "scheduler.h"
+#include "trace_buffer.h"
+
+#define TRIE_ROOT 0
+#define TRIE_NONE 0xFF
+
+static bool leading = false;
+static uint8_t trie_node = TRIE_ROOT;
+// Keys of the sequence so far, and how many of them the longest complete
+// sequence among them covers.
+static uint8_t keys[LEADER_TRIE_DEPTH];
+static uint8_t num_keys = 0;
+static uint8_t matched_keys = 0;
+static uint8_t matched_action = LEADER_NONE;
+
+static uint32_t last_key_time = 0;
+static scheduler_token_t timeout_token = SCHEDULER_NO_TOKEN;
+
+// Keys whose press a sequence consumed, until their release, which is
+// consumed too. Other releases pass through, even while leading.
+static matrix_row_t consumed[MATRIX_ROWS];
+static uint8_t num_consumed = 0;
+
+// Follows the edge labeled `keycode` out of `node`.
+static uint8_t trie_next(uint8_t node, uint16_t keycode) {
+  if (keycode > 0xFF) {
+    return TRIE_NONE;
+  }
+  const uint8_t end = pgm_read_byte(&leader_trie_edges[node + 1]);
+  for (uint8_t e = pgm_read_byte(&leader_trie_edges[node]); e < end; ++e) {
+    const uint8_t key = pgm_read_byte(&leader_trie_keys[e]);
+    if (key == keycode) {
+      return e + 1;  // Edge e leads to node e + 1.
+    } else if (key > keycode) {
+      break;  // Edges are sorted by keycode.
+    }
+  }
+  return TRIE_NONE;
+}
+
+static bool trie_is_leaf(uint8_t node) {
+  return pgm_read_byte(&leader_trie_edges[node]) ==
+         pgm_read_byte(&leader_trie_edges[node + 1]);
+}
+
+// Runs the longest complete sequence and types the keys after it.
+static void leader_end(void) {
+  leading = false;
+  scheduler_cancel(timeout_token);
+  timeout_token = SCHEDULER_NO_TOKEN;
+
+  TRACE(LEADER, matched_action, num_keys - matched_keys, 0);
+  if (matched_action != LEADER_NONE) {
+    leader_trie_action_user(matched_action);
+  }
+  for (uint8_t i = matched_keys; i < num_keys; ++i) {
+    tap_code16(keys[i]);
+  }
+}
+
+static uint32_t leader_timeout(uint32_t now, void* arg) {
+  const uint32_t idle = now - last_key_time;
+  if (idle < LEADER_TIMEOUT) {
+    return LEADER_TIMEOUT - idle;
+  }
+  timeout_token = SCHEDULER_NO_TOKEN;
+  leader_end();
+  return 0;
+}
+
+static void leader_start(void) {
+  leading = true;
+  trie_node = TRIE_ROOT;
+  num_keys = 0;
+  matched_keys = 0;
+  matched_action = LEADER_NONE;
+  last_key_time = timer_read32();
+  if (timeout_token == SCHEDULER_NO_TOKEN) {
+    timeout_token = scheduler_defer(LEADER_TIMEOUT, leader_timeout, NULL);
+  }
+}
+
+// Consumes the event, remembering the key to also consume its release.
+static bool consume(keyrecord_t* record) {
+  const keypos_t key = record->event.key;
+  if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+    const matrix_row_t bit = (matrix_row_t)1 << key.col;
+    if (!(consumed[key.row] & bit)) {
+      consumed[key.row] |= bit;
+      ++num_consumed;
+    }
+  }
+  return false;
+}
+
+// Whether the release of this key is consumed, as its press was.
+static bool consume_release(keyrecord_t* record) {
+  const keypos_t key = record->event.key;
+  if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+    const matrix_row_t bit = (matrix_row_t)1 << key.col;
+    if (consumed[key.row] & bit) {
+      consumed[key.row] &= ~bit;
+      --num_consumed;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool leader_trie_active(void) { return leading; }
+
+bool leader_trie_holding(void) { return num_consumed > 0; }
+
+bool process_leader_trie(uint16_t keycode, keyrecord_t* record) {
+  if (!record->event.pressed) {
+    return !consume_release(record);
+  }
+  if (!leading) {
+    if (keycode == QK_LEAD) {
+      leader_start();
+      return consume(record);
+    }
+    return true;
+  }
+
+#ifndef NO_ACTION_TAPPING
+  if (IS_QK_MOD_TAP(keycode)) {
+    keycode = QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+  }
+#ifndef NO_ACTION_LAYER
+  else if (IS_QK_LAYER_TAP(keycode)) {
+    keycode = QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+  }
+#endif  // NO_ACTION_LAYER
+#endif  // NO_ACTION_TAPPING
+
+  const uint8_t next = trie_next(trie_node, keycode);
+  if (next == TRIE_NONE) {
+    // Doesn't continue any sequence: end it and handle this key normally,
+    // starting over if it is the leader key.
+    leader_end();
+    if (keycode == QK_LEAD) {
+      leader_start();
+      return consume(record);
+    }
+    return true;
+  }
+
+  trie_node = next;
+  keys[num_keys++] = keycode;
+  const uint8_t action = pgm_read_byte(&leader_trie_actions[trie_node]);
+  if (action != LEADER_NONE) {
+    matched_keys = num_keys;
+    matched_action = action;
+  }
+  if (trie_is_leaf(trie_node)) {
+    leader_end();  // Can't be extended, no need to wait.
+  } else {
+    last_key_time = timer_read32();
+  }
+  return consume(record);
+}
@@ -0,0 +1,84 @@
+/**
+ * @file leader_trie.h
+ * @brief Leader trie: leader sequences that fire as soon as they are typed.
+ *
+ * QMK's leader key collects keys until `LEADER_TIMEOUT` passes without a key
+ * press, and only then calls `leader_end_user()` to match the sequence, so
+ * every sequence waits out the timeout. Here the sequences are declared in
+ * leader.txt next to keymap.c, which scripts/gen_leader.py compiles into a
+ * trie in PROGMEM (leader_sequences.h). The trie is walked one key at a time:
+ *
+ *  * a sequence that can't be extended by more keys fires right away,
+ *  * when the next key doesn't continue any sequence, the longest sequence
+ *    typed so far fires, and the keys after it, including this one, are typed
+ *    as normal keystrokes,
+ *  * after `LEADER_TIMEOUT` ms without a key press, the same happens without
+ *    a next key.
+ *
+ * So only sequences that are a prefix of another one wait for the timeout.
+ * Keys are typed with `tap_code16()`, so only basic and modified keycodes
+ * pass through; mod-taps and layer-taps count as their tap keycode. The
+ * release of a key whose press the sequence consumed is consumed as well;
+ * other releases, like that of a key held down before the leader key, pass
+ * through, so nothing is left stuck.
+ *
+ * Handle the actions of leader.txt in keymap.c:
+ *
+ *     void leader_trie_action_user(uint8_t action) {
+ *       switch (action) {
+ *         case LEADER_SCREEN_LOCK:
+ *           tap_code16(G(KC_L));
+ *           break;
+ *       }
+ *     }
+ *
+ * and call `process_leader_trie()` early in `process_record_user()`. The
+ * timeout runs on the scheduler, see features/scheduler.h.
+ *
+ * Enable with `LEADER_TRIE_ENABLE = yes` in rules.mk, which replaces QMK's
+ * leader key (`LEADER_ENABLE`); `QK_LEAD` starts a sequence.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef LEADER_TRIE_ENABLE
+#include "leader_sequences.h"
+#endif  // LEADER_TRIE_ENABLE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef LEADER_TIMEOUT
+#define LEADER_TIMEOUT 300
+#endif  // LEADER_TIMEOUT
+
+#ifdef LEADER_TRIE_ENABLE
+
+/** Handler function for the leader trie. */
+bool process_leader_trie(uint16_t keycode, keyrecord_t* record);
+
+/** Whether a leader sequence is being typed. */
+bool leader_trie_active(void);
+
+/** Whether keys pressed in a sequence are held, their releases consumed. */
+bool leader_trie_holding(void);
+
+/** Runs `action`, a `LEADER_*` value from leader.txt. Define in keymap.c. */
+void leader_trie_action_user(uint8_t action);
+
+#else
+
+static inline bool process_leader_trie(uint16_t keycode, keyrecord_t* record) {
+  return true;
+}
+static inline bool leader_trie_active(void) { return false; }
+static inline bool leader_trie_holding(void) { return false; }
+
+#endif  // LEADER_TRIE_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
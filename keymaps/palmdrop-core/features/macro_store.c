@@ -0,0 +1,562 @@
+/**
+ * @file macro_store.c
+ * @brief Macro store implementation
+ */
+
+#include "macro_store.h"
+
+#include <string.h>
+
+#include "driver_wrap.h"
+#include "scheduler.h"
+
+// Changes with the layout, so stale stores aren't loaded.
+#define EEPROM_MAGIC (0x3D00 | MACRO_STORE_SLOTS)
+
+#if MACRO_STORE_RING_SIZE & (MACRO_STORE_RING_SIZE - 1)
+#error "macro_store: MACRO_STORE_RING_SIZE must be a power of two"
+#endif
+
+// Longest encoded event: a 3 byte event varint and a 3 byte delay.
+#define MAX_EVENT_SIZE 6
+
+// The store, in RAM as in EEPROM. Macros lie anywhere in the pool.
+typedef struct {
+  uint16_t magic;
+  uint16_t offset[MACRO_STORE_SLOTS];
+  uint16_t length[MACRO_STORE_SLOTS];
+  uint8_t pool[MACRO_STORE_SIZE];
+} macro_store_t;
+
+_Static_assert(MACRO_STORE_EEPROM_ADDR + sizeof(macro_store_t) <=
+                   TOTAL_EEPROM_BYTE_COUNT,
+               "macro_store: the store doesn't fit in EEPROM, lower "
+               "MACRO_STORE_SIZE or MACRO_STORE_SLOTS");
+
+typedef struct {
+  uint16_t keycode;
+  bool pressed;
+  uint16_t delay;
+} macro_event_t;
+
+// Reads the events of a macro, from the pool or around the ring.
+typedef struct {
+  const uint8_t* buffer;
+  uint16_t size;
+  uint16_t pos;
+  uint16_t remaining;
+  uint16_t keycode;
+} macro_cursor_t;
+
+// What the next event is encoded against.
+typedef struct {
+  uint16_t keycode;
+  uint16_t time;
+  bool first;
+  bool timed;  // Whether delays are recorded.
+} macro_encoder_t;
+
+static macro_store_t store;
+static scheduler_token_t save_token = SCHEDULER_NO_TOKEN;
+
+// The record or play key waiting for a slot key, and the slot key's position,
+// whose release is swallowed.
+static uint16_t awaiting = KC_NO;
+static bool swallowing = false;
+static keypos_t swallow_key;
+
+// The macro being recorded.
+static uint8_t recording = MACRO_STORE_NONE;
+static macro_encoder_t recording_encoder;
+static bool full;
+
+// Everything typed, in segments ended by the boundary key. Positions count
+// bytes ever written, the ring index is the position modulo its size.
+static uint8_t ring[MACRO_STORE_RING_SIZE];
+static uint16_t ring_head = 0;
+static macro_encoder_t ring_encoder = {.first = true};  // Replayed untimed.
+static uint16_t segment_start = 0;
+static uint8_t segment_events = 0;
+// The last completed segments, oldest first from `oldest_segment`.
+typedef struct {
+  uint16_t start;
+  uint16_t end;
+} macro_segment_t;
+static macro_segment_t segments[MACRO_STORE_REPLAY_SEGMENTS];
+static uint8_t oldest_segment = 0;
+static uint8_t num_segments = 0;
+
+// Timed playback, and whether events are being played back.
+static macro_cursor_t timed_cursor;
+static macro_event_t timed_event;
+static bool timed_event_due = false;
+static scheduler_token_t timed_token = SCHEDULER_NO_TOKEN;
+static bool replaying = false;
+
+// Max speed playback: the driver that reports are held back from, the report
+// last sent to it and the one held back.
+static host_driver_t* unpacked_driver = NULL;
+static host_driver_t packing_driver;
+static report_keyboard_t packed_sent;
+static report_keyboard_t packed;
+static bool has_packed = false;
+
+__attribute__((weak)) uint8_t macro_store_slot(uint16_t keycode) {
+  if (keycode >= KC_A && keycode < KC_A + MACRO_STORE_SLOTS) {
+    return keycode - KC_A;
+  }
+  return MACRO_STORE_NONE;
+}
+
+__attribute__((weak)) bool macro_store_custom_tap(uint16_t keycode) {
+  return false;
+}
+
+bool macro_store_recording(void) { return recording != MACRO_STORE_NONE; }
+
+static uint8_t put_varint(uint8_t* out, uint32_t value) {
+  uint8_t size = 0;
+  while (value >= 0x80) {
+    out[size++] = (value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  out[size++] = value;
+  return size;
+}
+
+static uint32_t get_varint(macro_cursor_t* cursor) {
+  uint32_t value = 0;
+  for (uint8_t shift = 0; cursor->remaining; shift += 7) {
+    const uint8_t byte = cursor->buffer[cursor->pos];
+    if (++cursor->pos == cursor->size) {
+      cursor->pos = 0;
+    }
+    --cursor->remaining;
+    value |= (uint32_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      break;
+    }
+  }
+  return value;
+}
+
+static bool read_event(macro_cursor_t* cursor, macro_event_t* event) {
+  if (!cursor->remaining) {
+    return false;
+  }
+  const uint32_t head = get_varint(cursor);
+  const uint16_t zigzag = head >> 2;
+  cursor->keycode += (zigzag >> 1) ^ -(zigzag & 1);
+  event->keycode = cursor->keycode;
+  event->pressed = head & 1;
+  event->delay = (head & 2) ? get_varint(cursor) : 0;
+  return true;
+}
+
+static uint8_t encode_event(macro_encoder_t* encoder, uint16_t keycode,
+                            bool pressed, uint16_t time, uint8_t* bytes) {
+  const uint16_t delay = time - encoder->time;
+  const bool has_delay =
+      encoder->timed && !encoder->first && delay >= MACRO_STORE_MIN_DELAY;
+  const int16_t delta = keycode - encoder->keycode;
+  const uint16_t zigzag = (uint16_t)(delta << 1) ^ (uint16_t)(delta >> 15);
+  uint8_t size =
+      put_varint(bytes, (uint32_t)zigzag << 2 | has_delay << 1 | pressed);
+  if (has_delay) {
+    size += put_varint(bytes + size, delay);
+  }
+  encoder->keycode = keycode;
+  encoder->time = time;
+  encoder->first = false;
+  return size;
+}
+
+static macro_cursor_t slot_cursor(uint8_t slot) {
+  return (macro_cursor_t){
+      .buffer = store.pool,
+      .size = MACRO_STORE_SIZE,
+      .pos = store.offset[slot],
+      .remaining = store.length[slot],
+  };
+}
+
+static macro_cursor_t ring_cursor(uint16_t start, uint16_t end) {
+  return (macro_cursor_t){
+      .buffer = ring,
+      .size = MACRO_STORE_RING_SIZE,
+      .pos = start % MACRO_STORE_RING_SIZE,
+      .remaining = end - start,
+  };
+}
+
+static uint32_t macro_store_save(uint32_t now, void* arg) {
+  save_token = SCHEDULER_NO_TOKEN;
+  eeprom_update_block(&store, (void*)MACRO_STORE_EEPROM_ADDR, sizeof(store));
+  return 0;
+}
+
+void macro_store_init(void) {
+  eeprom_read_block(&store, (const void*)MACRO_STORE_EEPROM_ADDR,
+                    sizeof(store));
+  bool valid = store.magic == EEPROM_MAGIC;
+  for (uint8_t i = 0; valid && i < MACRO_STORE_SLOTS; ++i) {
+    valid = store.offset[i] + store.length[i] <= MACRO_STORE_SIZE;
+  }
+  if (!valid) {
+    // Erased, or saved with another layout.
+    memset(&store, 0, sizeof(store));
+    store.magic = EEPROM_MAGIC;
+  }
+}
+
+// Moves the macros to the start of the pool, in the order they lie in.
+static void compact(void) {
+  uint8_t moved[MACRO_STORE_SLOTS] = {0};
+  uint16_t end = 0;
+  for (;;) {
+    uint8_t next = MACRO_STORE_NONE;
+    for (uint8_t i = 0; i < MACRO_STORE_SLOTS; ++i) {
+      const bool used = store.length[i] || i == recording;
+      if (used && !moved[i] &&
+          (next == MACRO_STORE_NONE || store.offset[i] < store.offset[next])) {
+        next = i;
+      }
+    }
+    if (next == MACRO_STORE_NONE) {
+      return;
+    }
+    memmove(&store.pool[end], &store.pool[store.offset[next]],
+            store.length[next]);
+    store.offset[next] = end;
+    end += store.length[next];
+    moved[next] = true;
+  }
+}
+
+// Appends to the macro being recorded, which is the last one in the pool.
+static bool append(const uint8_t* bytes, uint8_t size) {
+  if (store.offset[recording] + store.length[recording] + size >
+      MACRO_STORE_SIZE) {
+    compact();
+    if (store.offset[recording] + store.length[recording] + size >
+        MACRO_STORE_SIZE) {
+      return false;
+    }
+  }
+  memcpy(&store.pool[store.offset[recording] + store.length[recording]], bytes,
+         size);
+  store.length[recording] += size;
+  return true;
+}
+
+static void record_to_slot(uint16_t keycode, bool pressed, uint16_t time) {
+  if (full) {
+    return;
+  }
+  macro_encoder_t encoder = recording_encoder;
+  uint8_t bytes[MAX_EVENT_SIZE];
+  const uint8_t size = encode_event(&encoder, keycode, pressed, time, bytes);
+  if (!append(bytes, size)) {
+    full = true;  // Later events are dropped, the macro ends here.
+    return;
+  }
+  recording_encoder = encoder;
+}
+
+// Constant work per event: the oldest bytes are overwritten, and segments
+// that lost bytes are only noticed when replaying.
+static void record_to_ring(uint16_t keycode, bool pressed, uint16_t time) {
+  uint8_t bytes[MAX_EVENT_SIZE];
+  const uint8_t size =
+      encode_event(&ring_encoder, keycode, pressed, time, bytes);
+  for (uint8_t i = 0; i < size; ++i) {
+    ring[ring_head++ % MACRO_STORE_RING_SIZE] = bytes[i];
+  }
+  if (segment_events < UINT8_MAX) {
+    ++segment_events;
+  }
+}
+
+static void record_event(uint16_t keycode, bool pressed, uint16_t time) {
+  if (recording != MACRO_STORE_NONE) {
+    record_to_slot(keycode, pressed, time);
+  }
+  record_to_ring(keycode, pressed, time);
+}
+
+// Records what the key did: tap-hold keys as their tap or their hold, and
+// taps the keymap handles as the key itself.
+static void record_key(uint16_t keycode, keyrecord_t* record) {
+  const bool pressed = record->event.pressed;
+  const uint16_t time = record->event.time;
+  if (record->tap.count && macro_store_custom_tap(keycode)) {
+    record_event(keycode, pressed, time);
+    return;
+  }
+  if (IS_QK_MOD_TAP(keycode)) {
+    if (record->tap.count) {
+      record_event(QK_MOD_TAP_GET_TAP_KEYCODE(keycode), pressed, time);
+      return;
+    }
+    const uint8_t mods = QK_MOD_TAP_GET_MODS(keycode);
+    const uint8_t mod_bits = (mods & 0x10) ? (mods & 0x0F) << 4 : mods;
+    for (uint8_t i = 0; i < 8; ++i) {
+      if (mod_bits & (1 << i)) {
+        record_event(KC_LCTL + i, pressed, time);
+      }
+    }
+    return;
+  }
+  if (IS_QK_LAYER_TAP(keycode)) {
+    record_event(record->tap.count ? QK_LAYER_TAP_GET_TAP_KEYCODE(keycode)
+                                   : MO(QK_LAYER_TAP_GET_LAYER(keycode)),
+                 pressed, time);
+    return;
+  }
+  record_event(keycode, pressed, time);
+}
+
+static void start_recording(uint8_t slot) {
+  scheduler_cancel(timed_token);
+  timed_token = SCHEDULER_NO_TOKEN;
+  // Into the free space after the other macros, which stay where they are.
+  store.length[slot] = 0;
+  uint16_t end = 0;
+  for (uint8_t i = 0; i < MACRO_STORE_SLOTS; ++i) {
+    if (store.length[i] && store.offset[i] + store.length[i] > end) {
+      end = store.offset[i] + store.length[i];
+    }
+  }
+  store.offset[slot] = end;
+  recording = slot;
+  recording_encoder = (macro_encoder_t){.first = true, .timed = true};
+  full = false;
+}
+
+static void stop_recording(void) {
+  recording = MACRO_STORE_NONE;
+  scheduler_cancel(save_token);
+  save_token =
+      scheduler_defer(MACRO_STORE_SAVE_DELAY, macro_store_save, NULL);
+}
+
+// Plays an event back through the keymap, like a key would be. Tap-hold
+// keys are only recorded for their taps.
+static void play_event(const macro_event_t* event) {
+  keyrecord_t record = {
+      .event =
+          {
+              .key = {.row = MACRO_STORE_KEYLOC, .col = MACRO_STORE_KEYLOC},
+              .time = timer_read(),
+              .type = KEY_EVENT,
+              .pressed = event->pressed,
+          },
+      .tap = {.count = IS_QK_MOD_TAP(event->keycode) ||
+                       IS_QK_LAYER_TAP(event->keycode)},
+      .keycode = event->keycode,
+  };
+  replaying = true;
+  process_record(&record);
+  replaying = false;
+}
+
+static void flush_packed(void) {
+  if (has_packed) {
+    has_packed = false;
+    packed_sent = packed;
+    unpacked_driver->send_keyboard(&packed);
+  }
+}
+
+// Holds reports back while the next ones can be merged into them, see
+// driver_wrap_can_merge().
+static void pack_report(report_keyboard_t* report) {
+  if (has_packed && !driver_wrap_can_merge(&packed_sent, &packed, report)) {
+    flush_packed();
+  }
+  packed = *report;
+  has_packed = true;
+}
+
+// Plays the events back with their reports packed into as few as their order
+// allows. What the host has before isn't known, so it counts as an empty
+// report: that only splits reports more often.
+static void play_max_speed(macro_cursor_t cursor) {
+  unpacked_driver = host_get_driver();
+  if (unpacked_driver) {
+    packing_driver = *unpacked_driver;
+    packing_driver.send_keyboard = pack_report;
+    host_set_driver(&packing_driver);
+    memset(&packed_sent, 0, sizeof(packed_sent));
+  }
+  macro_event_t event;
+  while (read_event(&cursor, &event)) {
+    play_event(&event);
+  }
+  if (unpacked_driver) {
+    flush_packed();
+    host_set_driver(unpacked_driver);
+  }
+}
+
+// Ends the segment on the boundary key's release. A lone boundary key isn't
+// a segment of its own.
+static void end_segment(void) {
+  if (segment_events > 2) {
+    uint8_t index = oldest_segment + num_segments;
+    if (num_segments == MACRO_STORE_REPLAY_SEGMENTS) {
+      index = oldest_segment;
+      oldest_segment = (oldest_segment + 1) % MACRO_STORE_REPLAY_SEGMENTS;
+    } else {
+      ++num_segments;
+    }
+    segments[index % MACRO_STORE_REPLAY_SEGMENTS] =
+        (macro_segment_t){.start = segment_start, .end = ring_head};
+  }
+  segment_start = ring_head;
+  segment_events = 0;
+  ring_encoder = (macro_encoder_t){.first = true};
+}
+
+// Plays the completed segments that are still whole in the ring.
+static void replay_segments(void) {
+  for (uint8_t i = 0; i < num_segments; ++i) {
+    const macro_segment_t* segment =
+        &segments[(oldest_segment + i) % MACRO_STORE_REPLAY_SEGMENTS];
+    if ((uint16_t)(ring_head - segment->start) <= MACRO_STORE_RING_SIZE) {
+      play_max_speed(ring_cursor(segment->start, segment->end));
+    }
+  }
+}
+
+static uint32_t macro_store_play_timed(uint32_t now, void* arg) {
+  for (;;) {
+    if (!timed_event_due) {
+      if (!read_event(&timed_cursor, &timed_event)) {
+        timed_token = SCHEDULER_NO_TOKEN;
+        return 0;
+      }
+      if (timed_event.delay) {
+        timed_event_due = true;
+        return timed_event.delay;
+      }
+    }
+    timed_event_due = false;
+    play_event(&timed_event);
+  }
+}
+
+static void play_timed(uint8_t slot) {
+  scheduler_cancel(timed_token);
+  timed_cursor = slot_cursor(slot);
+  timed_event_due = false;
+  timed_token = scheduler_defer(0, macro_store_play_timed, NULL);
+}
+
+// The basic keycode a key typed, KC_NO for the hold of a tap-hold key.
+static uint16_t tapped_keycode(uint16_t keycode, keyrecord_t* record) {
+  if (IS_QK_MOD_TAP(keycode)) {
+    return record->tap.count ? QK_MOD_TAP_GET_TAP_KEYCODE(keycode) : KC_NO;
+  }
+  if (IS_QK_LAYER_TAP(keycode)) {
+    return record->tap.count ? QK_LAYER_TAP_GET_TAP_KEYCODE(keycode) : KC_NO;
+  }
+  return keycode;
+}
+
+static void swallow_release(keyrecord_t* record) {
+  swallowing = true;
+  swallow_key = record->event.key;
+}
+
+// Starts what the record or play key asked for, on the slot key. Returns
+// false if the key isn't a slot key.
+static bool select_slot(uint16_t keycode, keyrecord_t* record) {
+  const uint16_t key_action = awaiting;
+  awaiting = KC_NO;
+  const uint8_t slot = macro_store_slot(tapped_keycode(keycode, record));
+  if (slot >= MACRO_STORE_SLOTS) {
+    return false;  // Not a slot key, typed as usual.
+  }
+  swallow_release(record);
+  switch (key_action) {
+    case DM_REC1:
+    case DM_REC2:
+      start_recording(slot);
+      break;
+    case DM_PLY1:
+      play_max_speed(slot_cursor(slot));
+      break;
+    case DM_PLY2:
+      play_timed(slot);
+      break;
+  }
+  return true;
+}
+
+bool process_macro_store(uint16_t keycode, keyrecord_t* record,
+                         uint16_t replay_keycode) {
+  if (replaying) {
+    return true;
+  }
+  const bool pressed = record->event.pressed;
+  if (swallowing && !pressed &&
+      record->event.key.row == swallow_key.row &&
+      record->event.key.col == swallow_key.col) {
+    swallowing = false;
+    return false;
+  }
+  if (keycode == replay_keycode) {
+    if (pressed) {
+      replay_segments();
+    }
+    return false;
+  }
+  const bool boundary =
+      tapped_keycode(keycode, record) == MACRO_STORE_BOUNDARY;
+
+  if (recording != MACRO_STORE_NONE) {
+    switch (keycode) {
+      case DM_RSTP:
+        if (pressed) {
+          stop_recording();
+        }
+        return false;
+      case DM_REC1:
+      case DM_REC2:
+      case DM_PLY1:
+      case DM_PLY2:
+        if (!pressed) {
+          stop_recording();
+        }
+        return false;
+    }
+    if (boundary && pressed) {
+      // The boundary key stops recording instead of being typed.
+      stop_recording();
+      swallow_release(record);
+      return false;
+    }
+  }
+
+  if (awaiting != KC_NO && pressed && select_slot(keycode, record)) {
+    return false;
+  }
+  switch (keycode) {
+    case DM_REC1:
+    case DM_REC2:
+    case DM_PLY1:
+    case DM_PLY2:
+      if (!pressed) {
+        awaiting = keycode;
+      }
+      return false;
+    case DM_RSTP:
+      return false;
+  }
+  record_key(keycode, record);
+  if (boundary && !pressed) {
+    end_segment();
+  }
+  return true;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file macro_store.h
+ * @brief Macro store: dynamic macros in many slots, compactly encoded and
+ * kept in EEPROM.
+ *
+ * QMK's dynamic macros keep one full `keyrecord_t` per event in RAM, for two
+ * macros that are gone on unplug. Here macros are recorded into
+ * `MACRO_STORE_SLOTS` slots that share a pool of `MACRO_STORE_SIZE` bytes, one
+ * varint per event:
+ *
+ *     zigzag(keycode - previous keycode) << 2 | has delay << 1 | pressed
+ *
+ * followed by a varint delay in ms when the event came at least
+ * `MACRO_STORE_MIN_DELAY` ms after the previous one. Typed text is mostly one
+ * byte per event, so the pool holds several times as many events as the same
+ * RAM of records would.
+ *
+ * The store is also the EEPROM image, saved from `MACRO_STORE_EEPROM_ADDR`
+ * `MACRO_STORE_SAVE_DELAY` ms after the last recording ends, so re-recording a
+ * slot a few times writes once. Only bytes that changed are written, and a
+ * slot re-recorded goes into free space at the end of the pool instead of
+ * shifting the others, which only move when the pool has to be compacted.
+ *
+ * The keys are QMK's dynamic macro keycodes, followed by the slot key: a
+ * letter, a to h for 8 slots, unless `macro_store_slot()` is defined.
+ *
+ *   - `DM_REC1` then a slot key records into it, until `DM_RSTP`, `DM_REC1`
+ *     or Escape.
+ *   - `DM_PLY1` then a slot key plays it back at max speed, with events packed
+ *     into as few HID reports as their order allows.
+ *   - `DM_PLY2` then a slot key plays it back with the recorded delays.
+ *
+ * Events are played back through `process_record()` like keys, so features
+ * that change what a key types, like caps word or case mode, do so again as
+ * they did while recording.
+ *
+ * Everything typed is also recorded, always, into a ring of
+ * `MACRO_STORE_RING_SIZE` bytes, in segments ended by the release of
+ * `MACRO_STORE_BOUNDARY` (Escape, also as the tap of a tap-hold key). The
+ * replay key plays the last `MACRO_STORE_REPLAY_SEGMENTS` segments back at max
+ * speed, like vim's `.` repeats the last edit. Recording into the ring costs
+ * the same few bytes of work for every event: old events are overwritten
+ * without bookkeeping, and a segment that lost bytes is skipped on replay.
+ *
+ * Call `process_macro_store()` from `process_record_user()`, with the replay
+ * keycode, and
+ * `macro_store_init()` from `keyboard_post_init_user()`. Saving and timed
+ * playback run on the scheduler (features/scheduler.h).
+ *
+ * Enable with `MACRO_STORE_ENABLE = yes` in rules.mk, instead of
+ * `DYNAMIC_MACRO_ENABLE`.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of macros.
+#ifndef MACRO_STORE_SLOTS
+#define MACRO_STORE_SLOTS 8
+#endif  // MACRO_STORE_SLOTS
+
+// Bytes of encoded events shared by all macros.
+#ifndef MACRO_STORE_SIZE
+#define MACRO_STORE_SIZE 512
+#endif  // MACRO_STORE_SIZE
+
+// Shorter gaps between events are not recorded.
+#ifndef MACRO_STORE_MIN_DELAY
+#define MACRO_STORE_MIN_DELAY 20
+#endif  // MACRO_STORE_MIN_DELAY
+
+// Bytes of the ring of everything typed, a power of two.
+#ifndef MACRO_STORE_RING_SIZE
+#define MACRO_STORE_RING_SIZE 256
+#endif  // MACRO_STORE_RING_SIZE
+
+// Key that ends segments of the ring, and explicit recordings.
+#ifndef MACRO_STORE_BOUNDARY
+#define MACRO_STORE_BOUNDARY KC_ESC
+#endif  // MACRO_STORE_BOUNDARY
+
+// Segments of the ring played back by the replay key.
+#ifndef MACRO_STORE_REPLAY_SEGMENTS
+#define MACRO_STORE_REPLAY_SEGMENTS 1
+#endif  // MACRO_STORE_REPLAY_SEGMENTS
+
+// Delay in ms after a recording ends before the store is saved.
+#ifndef MACRO_STORE_SAVE_DELAY
+#define MACRO_STORE_SAVE_DELAY 5000
+#endif  // MACRO_STORE_SAVE_DELAY
+
+// Where the store is saved, by default after QMK's own config. The store,
+// 4 bytes per slot and MACRO_STORE_SIZE + 2, must fit in the EEPROM from there.
+#ifndef MACRO_STORE_EEPROM_ADDR
+#define MACRO_STORE_EEPROM_ADDR EECONFIG_SIZE
+#endif  // MACRO_STORE_EEPROM_ADDR
+
+#define MACRO_STORE_NONE 0xFF
+
+// Position of played back events, which have no key of their own.
+#define MACRO_STORE_KEYLOC 253
+
+/**
+ * Optional callback, the slot that `keycode` (a basic keycode) selects after
+ * a record or play key, or `MACRO_STORE_NONE`. The default is KC_A for slot 0
+ * and so on.
+ */
+uint8_t macro_store_slot(uint16_t keycode);
+
+/**
+ * Optional callback, whether the keymap handles the tap of tap-hold key
+ * `keycode` itself, like `LT(_RAISE, CK_OSFT)` whose tap keycode only holds
+ * the low byte of a custom keycode. Such taps are recorded as the key and
+ * replayed through `process_record()` as a tap, other taps as their tap
+ * keycode. The default is false for every key.
+ */
+bool macro_store_custom_tap(uint16_t keycode);
+
+#ifdef MACRO_STORE_ENABLE
+
+/** Handler function for the macro store. */
+bool process_macro_store(uint16_t keycode, keyrecord_t* record,
+                         uint16_t replay_keycode);
+
+/** Loads the saved macros. */
+void macro_store_init(void);
+
+/** Whether a macro is being recorded. */
+bool macro_store_recording(void);
+
+#else
+
+static inline bool process_macro_store(uint16_t keycode, keyrecord_t* record,
+                                       uint16_t replay_keycode) {
+  return true;
+}
+static inline void macro_store_init(void) {}
+static inline bool macro_store_recording(void) { return false; }
+
+#endif  // MACRO_STORE_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
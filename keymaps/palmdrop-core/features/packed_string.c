@@ -0,0 +1,143 @@
+/**
+ * @file packed_string.c
+ * @brief Packed strings implementation
+ */
+
+#include "packed_string.h"
+
+#include <string.h>
+
+#ifdef NKRO_ENABLE
+#define MAX_RUN_KEYS 16
+#else
+#define MAX_RUN_KEYS 6
+#endif  // NKRO_ENABLE
+
+// Keys of the run being packed, pressed in the report not sent yet, and the
+// modifiers applied for it.
+static uint8_t run_keys[MAX_RUN_KEYS];
+static uint8_t num_run_keys = 0;
+static uint8_t run_mods = 0;
+// Keys of the run sent last, released in the report that presses the next.
+static uint8_t sent_keys[MAX_RUN_KEYS];
+static uint8_t num_sent_keys = 0;
+
+static uint8_t run_capacity(void) {
+#ifdef NKRO_ENABLE
+  if (keymap_config.nkro) {
+    return MAX_RUN_KEYS;
+  }
+#endif  // NKRO_ENABLE
+  return 6;
+}
+
+static bool has_key(const uint8_t* keys, uint8_t num_keys, uint8_t keycode) {
+  for (uint8_t i = 0; i < num_keys; ++i) {
+    if (keys[i] == keycode) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Whether `keycode` can join the run without changing what the host types.
+// A key of the last run is still pressed, so it can't be typed again before
+// the report that releases it.
+static bool run_accepts(uint8_t keycode, uint8_t mods) {
+  if (mods != run_mods || num_run_keys == run_capacity() ||
+      has_key(run_keys, num_run_keys, keycode) ||
+      has_key(sent_keys, num_sent_keys, keycode)) {
+    return false;
+  }
+#ifdef NKRO_ENABLE
+  // The bitmap has no order of its own, keys are read by keycode.
+  if (keymap_config.nkro && keycode < run_keys[num_run_keys - 1]) {
+    return false;
+  }
+#endif  // NKRO_ENABLE
+  return true;
+}
+
+static void set_run_mods(uint8_t mods) {
+  del_weak_mods(run_mods);
+  add_weak_mods(mods);
+  run_mods = mods;
+}
+
+static void release_sent(void) {
+  for (uint8_t i = 0; i < num_sent_keys; ++i) {
+    del_key(sent_keys[i]);
+  }
+  num_sent_keys = 0;
+}
+
+// Sends the run pressed. Its keys are released along with the next run.
+static void send_run(void) {
+  send_keyboard_report();
+  memcpy(sent_keys, run_keys, num_run_keys);
+  num_sent_keys = num_run_keys;
+  num_run_keys = 0;
+}
+
+// Starts a run with `keycode`. The last run is released in the same report,
+// unless `keycode` is one of its keys, which has to be released first.
+static void start_run(uint8_t keycode, uint8_t mods) {
+  const bool repeated = has_key(sent_keys, num_sent_keys, keycode);
+  release_sent();
+  if (repeated) {
+    send_keyboard_report();
+  }
+  set_run_mods(mods);
+}
+
+static void pack_char(char ascii_code) {
+  const uint8_t c = (uint8_t)ascii_code;
+  if (c >= 128) {
+    return;
+  }
+  const uint8_t keycode = pgm_read_byte(&ascii_to_keycode_lut[c]);
+  if (keycode == KC_NO) {
+    return;
+  }
+  uint8_t mods = 0;
+  if (PGM_LOADBIT(ascii_to_shift_lut, c)) {
+    mods |= MOD_BIT(KC_LSFT);
+  }
+  if (PGM_LOADBIT(ascii_to_altgr_lut, c)) {
+    mods |= MOD_BIT(KC_RALT);
+  }
+
+  if (num_run_keys && !run_accepts(keycode, mods)) {
+    send_run();
+  }
+  if (!num_run_keys) {
+    start_run(keycode, mods);
+  }
+  add_key(keycode);
+  run_keys[num_run_keys++] = keycode;
+}
+
+static void end_string(void) {
+  if (num_run_keys) {
+    send_run();
+  }
+  if (num_sent_keys) {
+    release_sent();
+    set_run_mods(0);
+    send_keyboard_report();
+  }
+}
+
+void send_string_packed(const char* str) {
+  for (; *str; ++str) {
+    pack_char(*str);
+  }
+  end_string();
+}
+
+void send_string_packed_P(const char* str) {
+  for (char c; (c = pgm_read_byte(str)); ++str) {
+    pack_char(c);
+  }
+  end_string();
+}
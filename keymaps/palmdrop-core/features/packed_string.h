@@ -0,0 +1,62 @@
+/**
+ * @file packed_string.h
+ * @brief Packed strings: `SEND_STRING` with several keys per HID report.
+ *
+ * QMK's `send_string()` types every character as its own press and release
+ * report, plus two more for Shift or AltGr, and a report goes out at most
+ * once per USB poll. Here runs of distinct keys that need the same modifiers
+ * are pressed together in one report, the way fast typists roll keys, and
+ * released in the report that presses the next run. Hosts type the keys of a
+ * report in the order they appear in it, so
+ *
+ *     SEND_STRING_PACKED("git push");
+ *
+ * presses "git pu" in one report, releases them and presses "sh" in the
+ * second, and releases those in the third, 3 reports instead of 16. A run ends
+ * only where it has to:
+ *
+ *   - a key repeats, since a key can't be pressed twice in one report,
+ *   - the modifiers change, which would apply to the whole run,
+ *   - the report is full, 6 keys, or with NKRO a key doesn't come after the
+ *     previous one in the bitmap, which hosts read in keycode order.
+ *
+ * A run that starts with a key of the previous one, which is still pressed,
+ * needs a report releasing it first. Modifiers go into the press report of
+ * their run. Characters are looked up
+ * in the same tables as `send_string()` (`sendstring_*.h`); the `SS_TAP()`
+ * style escapes are not supported and are skipped.
+ *
+ * Enable with `PACKED_STRING_ENABLE = yes` in rules.mk. Otherwise the macros
+ * fall back to `send_string()`.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SEND_STRING_PACKED(string) send_string_packed_P(PSTR(string))
+
+#ifdef PACKED_STRING_ENABLE
+
+/** Types `str`, a string in RAM, with keys packed into reports. */
+void send_string_packed(const char* str);
+
+/** Types `str`, a string in flash, with keys packed into reports. */
+void send_string_packed_P(const char* str);
+
+#else
+
+static inline void send_string_packed(const char* str) { send_string(str); }
+static inline void send_string_packed_P(const char* str) {
+  send_string_P(str);
+}
+
+#endif  // PACKED_STRING_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
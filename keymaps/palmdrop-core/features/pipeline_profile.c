@@ -0,0 +1,167 @@
+/**
+ * @file pipeline_profile.c
+ * @brief Pipeline profile implementation
+ */
+
+#include "pipeline_profile.h"
+
+#include <string.h>
+
+#include "keycode_class.h"
+
+#if defined(PROTOCOL_CHIBIOS) && \
+    (defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__))
+#include <hal.h>
+#define PIPELINE_PROFILE_DWT
+#endif
+
+// Two buckets per power of two, covering up to 2^20 cycles (~14 ms at 72 MHz).
+#define HISTOGRAM_SIZE 40
+
+typedef struct {
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+  uint16_t histogram[HISTOGRAM_SIZE];
+} profile_stat_t;
+
+static profile_stat_t stage_stats[PIPELINE_PROFILE_MAX_STAGES];
+static profile_stat_t class_stats[NUM_KEYCODE_CLASSES];
+
+static uint32_t event_start = 0;
+static uint32_t stage_start = 0;
+static uint8_t event_class = KEYCODE_CLASS_BASIC;
+
+#ifdef PIPELINE_PROFILE_DWT
+static bool cycle_counter_enabled = false;
+
+__attribute__((weak)) uint32_t pipeline_profile_read_cycles(void) {
+  return DWT->CYCCNT;
+}
+#else
+__attribute__((weak)) uint32_t pipeline_profile_read_cycles(void) {
+  return timer_read32();
+}
+#endif  // PIPELINE_PROFILE_DWT
+
+// Histogram bucket of `value`: values 0 and 1 get their own buckets, then
+// every power of two is split in a lower and upper half.
+static uint8_t histogram_bucket(uint32_t value) {
+  if (value < 2) {
+    return value;
+  }
+  const uint8_t msb = 31 - __builtin_clz(value);
+  const uint8_t bucket = 2 * msb + ((value >> (msb - 1)) & 1);
+  return bucket < HISTOGRAM_SIZE ? bucket : HISTOGRAM_SIZE - 1;
+}
+
+// Largest value that falls in `bucket`.
+static uint32_t histogram_upper_bound(uint8_t bucket) {
+  if (bucket < 2) {
+    return bucket;
+  }
+  const uint8_t msb = bucket / 2;
+  const uint32_t half = (uint32_t)1 << (msb - 1);
+  return ((uint32_t)1 << msb) + (bucket & 1) * half + half - 1;
+}
+
+static void stat_add(profile_stat_t* stat, uint32_t value) {
+  if (stat->count == 0 || value < stat->min) {
+    stat->min = value;
+  }
+  if (value > stat->max) {
+    stat->max = value;
+  }
+  ++stat->count;
+  stat->sum += value;
+
+  uint16_t* bin = &stat->histogram[histogram_bucket(value)];
+  if (*bin == UINT16_MAX) {
+    // Halve everything rather than saturate, which keeps the shape intact.
+    for (uint8_t i = 0; i < HISTOGRAM_SIZE; ++i) {
+      stat->histogram[i] >>= 1;
+    }
+  }
+  ++*bin;
+}
+
+static uint32_t stat_p99(const profile_stat_t* stat) {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < HISTOGRAM_SIZE; ++i) {
+    total += stat->histogram[i];
+  }
+  const uint32_t target = total - total / 100;
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < HISTOGRAM_SIZE; ++i) {
+    seen += stat->histogram[i];
+    if (seen >= target) {
+      const uint32_t bound = histogram_upper_bound(i);
+      return bound < stat->max ? bound : stat->max;
+    }
+  }
+  return stat->max;
+}
+
+void pipeline_profile_begin(uint16_t keycode) {
+#ifdef PIPELINE_PROFILE_DWT
+  if (!cycle_counter_enabled) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    cycle_counter_enabled = true;
+  }
+#endif  // PIPELINE_PROFILE_DWT
+  event_class = keycode_class(keycode);
+  event_start = stage_start = pipeline_profile_read_cycles();
+}
+
+void pipeline_profile_stage(uint8_t stage) {
+  const uint32_t now = pipeline_profile_read_cycles();
+  if (stage < PIPELINE_PROFILE_MAX_STAGES) {
+    stat_add(&stage_stats[stage], now - stage_start);
+  }
+  // Exclude the bookkeeping above from the next stage.
+  stage_start = pipeline_profile_read_cycles();
+}
+
+void pipeline_profile_end(void) {
+  stat_add(&class_stats[event_class],
+           pipeline_profile_read_cycles() - event_start);
+}
+
+void pipeline_profile_reset(void) {
+  memset(stage_stats, 0, sizeof(stage_stats));
+  memset(class_stats, 0, sizeof(class_stats));
+}
+
+__attribute__((weak)) const char* pipeline_profile_stage_name(uint8_t stage) {
+  static char name[] = "stage 0";
+  name[6] = '0' + stage;
+  return name;
+}
+
+static void print_stat(const char* name, const profile_stat_t* stat) {
+  if (stat->count == 0) {
+    return;
+  }
+  uprintf("%-14s %8lu %8lu %8lu %8lu %8lu\n", name, (unsigned long)stat->count,
+          (unsigned long)stat->min, (unsigned long)(stat->sum / stat->count),
+          (unsigned long)stat_p99(stat), (unsigned long)stat->max);
+}
+
+void pipeline_profile_print(void) {
+  static const char* class_names[NUM_KEYCODE_CLASSES] = {
+      "alpha",     "basic", "mods",    "mod-tap",
+      "layer-tap", "layer", "quantum", "user",
+  };
+
+  uprintf("%-14s %8s %8s %8s %8s %8s\n", "cycles", "count", "min", "avg",
+          "p99", "max");
+  for (uint8_t i = 0; i < PIPELINE_PROFILE_MAX_STAGES; ++i) {
+    print_stat(pipeline_profile_stage_name(i), &stage_stats[i]);
+  }
+  for (uint8_t i = 0; i < NUM_KEYCODE_CLASSES; ++i) {
+    print_stat(class_names[i], &class_stats[i]);
+  }
+}
@@ -0,0 +1,95 @@
+/**
+ * @file pipeline_profile.h
+ * @brief Pipeline profile: per-stage latency of `process_record_user()`.
+ *
+ * Measures how long each stage of the key processing pipeline takes, using
+ * the DWT cycle counter on Cortex-M3/M4 (the STM32F303 on the Planck EZ). On
+ * the host build, the stub quantum layer provides a nanosecond clock instead.
+ *
+ * For every stage, and for the whole pipeline per keycode class, the min,
+ * average, max and p99 are collected. The p99 comes from a histogram with two
+ * buckets per power of two, so it is accurate to within ~25%.
+ *
+ * Wrap the body of `process_record_user()` and close every stage as it
+ * completes. Stages that are never reached (because an earlier stage
+ * returned false) are simply not counted for that event:
+ *
+ *     bool process_record_user(uint16_t keycode, keyrecord_t* record) {
+ *       pipeline_profile_begin(keycode);
+ *       const bool result = process_record_pipeline(keycode, record);
+ *       pipeline_profile_end();
+ *       return result;
+ *     }
+ *
+ *     static bool process_record_pipeline(uint16_t keycode,
+ *                                         keyrecord_t* record) {
+ *       if (!process_caps_word(keycode, record)) { return false; }
+ *       pipeline_profile_stage(STAGE_CAPS_WORD);
+ *       // ...
+ *     }
+ *
+ * Call `pipeline_profile_print()` (e.g. from a leader sequence) to dump the
+ * table to the console, and `pipeline_profile_reset()` to start over.
+ *
+ * Enable with `PIPELINE_PROFILE_ENABLE = yes` in rules.mk. When disabled, all
+ * functions compile to nothing.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of stages that can be profiled.
+#ifndef PIPELINE_PROFILE_MAX_STAGES
+#define PIPELINE_PROFILE_MAX_STAGES 8
+#endif  // PIPELINE_PROFILE_MAX_STAGES
+
+#ifdef PIPELINE_PROFILE_ENABLE
+
+/** Starts timing an event. Call first thing in `process_record_user()`. */
+void pipeline_profile_begin(uint16_t keycode);
+
+/** Closes `stage`: the time since the previous stage is attributed to it. */
+void pipeline_profile_stage(uint8_t stage);
+
+/** Finishes timing the event, attributing the total to its keycode class. */
+void pipeline_profile_end(void);
+
+/** Prints the per-stage and per-keycode-class table to the console. */
+void pipeline_profile_print(void);
+
+/** Clears all collected statistics. */
+void pipeline_profile_reset(void);
+
+/**
+ * Optional callback naming a stage in the printed table.
+ *
+ * The default names stages "stage 0", "stage 1", and so on.
+ */
+const char* pipeline_profile_stage_name(uint8_t stage);
+
+/**
+ * Optional override of the cycle counter.
+ *
+ * Defaults to DWT->CYCCNT on Cortex-M3/M4, and to the millisecond timer
+ * everywhere else (which is too coarse to be useful, but compiles).
+ */
+uint32_t pipeline_profile_read_cycles(void);
+
+#else
+
+static inline void pipeline_profile_begin(uint16_t keycode) {}
+static inline void pipeline_profile_stage(uint8_t stage) {}
+static inline void pipeline_profile_end(void) {}
+static inline void pipeline_profile_print(void) {}
+static inline void pipeline_profile_reset(void) {}
+
+#endif  // PIPELINE_PROFILE_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
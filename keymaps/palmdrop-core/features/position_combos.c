@@ -0,0 +1,218 @@
+/**
+ * @file position_combos.c
+ * @brief Position combos implementation
+ */
+
+#define POSITION_COMBO_TABLES
+#include "position_combos.h"
+
+#include <string.h>
+
+#include "scheduler.h"
+#include "trace_buffer.h"
+
+#define NO_COMBO 0xFF
+#define COMBO_BIT(combo) ((position_combo_mask_t)1 << (combo))
+
+// Key events held back while a combo is pending: presses of its keys, and
+// releases of other keys in between. The candidates are the combos that
+// contain all held back presses; `completed` is the last combo that had all
+// its keys held back, if any.
+static keyrecord_t buffer[POSITION_COMBO_BUFFER_SIZE];
+static uint8_t buffer_size = 0;
+static uint8_t num_pressed = 0;
+static position_combo_mask_t candidates = 0;
+static uint8_t completed = NO_COMBO;
+static uint16_t start_time = 0;  // First held back press.
+static scheduler_token_t timeout_token = SCHEDULER_NO_TOKEN;
+
+// Combos whose keycode is held, and keys whose release is swallowed because
+// they were part of a combo.
+static position_combo_mask_t active = 0;
+static matrix_row_t swallowed[MATRIX_ROWS];
+
+static position_combo_mask_t combos_at(keypos_t key) {
+  if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+    return 0;
+  }
+  const position_combo_mask_t* mask = &position_combo_index[key.row][key.col];
+  switch (sizeof(position_combo_mask_t)) {
+    case 1:
+      return pgm_read_byte(mask);
+    case 2:
+      return pgm_read_word(mask);
+    default:
+      return pgm_read_dword(mask);
+  }
+}
+
+static bool is_complete(uint8_t combo) {
+  return pgm_read_byte(&position_combo_sizes[combo]) == num_pressed;
+}
+
+// Drops the candidates that still miss keys and whose term has passed, and
+// returns the ms until the next one runs out, 0 if none is left.
+static uint16_t drop_expired(uint16_t time) {
+  const uint16_t elapsed = time - start_time;
+  uint16_t next = 0;
+  for (uint8_t combo = 0; combo < POSITION_COMBO_COUNT; ++combo) {
+    if (!(candidates & COMBO_BIT(combo)) || is_complete(combo)) {
+      continue;
+    }
+    const uint8_t term = pgm_read_byte(&position_combo_terms[combo]);
+    if (elapsed >= term) {
+      candidates &= ~COMBO_BIT(combo);
+    } else if (!next || term - elapsed < next) {
+      next = term - elapsed;
+    }
+  }
+  return next;
+}
+
+static void send_combo(uint8_t combo, uint16_t time, bool pressed) {
+  keyrecord_t record = {
+      .event =
+          {
+              .key = {.row = KEYLOC_COMBO, .col = KEYLOC_COMBO},
+              .time = time,
+              .type = COMBO_EVENT,
+              .pressed = pressed,
+          },
+      .keycode = pgm_read_word(&position_combo_keycodes[combo]),
+  };
+  process_record(&record);
+}
+
+// Fires the completed combo, or lets the held back keys through as they are.
+static void resolve(void) {
+  scheduler_cancel(timeout_token);
+  timeout_token = SCHEDULER_NO_TOKEN;
+
+  keyrecord_t records[POSITION_COMBO_BUFFER_SIZE];
+  const uint8_t count = buffer_size;
+  const uint8_t combo = completed;
+  memcpy(records, buffer, count * sizeof(keyrecord_t));
+  buffer_size = 0;
+  num_pressed = 0;
+  candidates = 0;
+  completed = NO_COMBO;
+  TRACE(COMBO, combo + 1, count, timer_read() - start_time);
+
+  // The combo goes out in place of its last key, presses held back after it
+  // when a longer combo didn't complete are let through after it.
+  uint8_t keys_left =
+      combo != NO_COMBO ? pgm_read_byte(&position_combo_sizes[combo]) : 0;
+  for (uint8_t i = 0; i < count; ++i) {
+    const keypos_t key = records[i].event.key;
+    if (keys_left && records[i].event.pressed &&
+        (combos_at(key) & COMBO_BIT(combo))) {
+      swallowed[key.row] |= (matrix_row_t)1 << key.col;
+      if (--keys_left == 0) {
+        active |= COMBO_BIT(combo);
+        send_combo(combo, start_time, true);
+      }
+    } else {
+      action_tapping_process(records[i]);
+    }
+  }
+}
+
+static uint32_t position_combo_timeout(uint32_t now, void* arg) {
+  const uint16_t next = drop_expired(timer_read());
+  if (next) {
+    return next;
+  }
+  timeout_token = SCHEDULER_NO_TOKEN;
+  resolve();
+  return 0;
+}
+
+// Holds back the press of a key in `combos`, which contain all held back
+// presses so far.
+static void hold_back(keyrecord_t* record, position_combo_mask_t combos) {
+  buffer[buffer_size++] = *record;
+  ++num_pressed;
+  candidates = combos;
+  for (uint8_t combo = 0; combo < POSITION_COMBO_COUNT; ++combo) {
+    if ((candidates & COMBO_BIT(combo)) && is_complete(combo)) {
+      completed = combo;
+    }
+  }
+  // Fire right away unless a longer combo can still complete.
+  const uint16_t next = drop_expired(record->event.time);
+  if (!next) {
+    resolve();
+  } else if (timeout_token == SCHEDULER_NO_TOKEN) {
+    timeout_token = scheduler_defer(next, position_combo_timeout, NULL);
+  }
+}
+
+static bool is_held_back(keypos_t key) {
+  for (uint8_t i = 0; i < buffer_size; ++i) {
+    if (buffer[i].event.pressed && buffer[i].event.key.row == key.row &&
+        buffer[i].event.key.col == key.col) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool position_combo_key(keypos_t key) { return combos_at(key) != 0; }
+
+bool position_combo_pair(keypos_t a, keypos_t b) {
+  return (combos_at(a) & combos_at(b)) != 0;
+}
+
+bool process_position_combos(uint16_t keycode, keyrecord_t* record) {
+  if (record->event.type != KEY_EVENT) {
+    return true;
+  }
+  const keypos_t key = record->event.key;
+
+  if (!record->event.pressed) {
+    const matrix_row_t bit = (matrix_row_t)1 << key.col;
+    if (swallowed[key.row] & bit) {
+      // The first key released ends the combo, the others are ignored.
+      swallowed[key.row] &= ~bit;
+      const position_combo_mask_t ended = active & combos_at(key);
+      active &= ~ended;
+      for (uint8_t combo = 0; combo < POSITION_COMBO_COUNT; ++combo) {
+        if (ended & COMBO_BIT(combo)) {
+          send_combo(combo, record->event.time, false);
+        }
+      }
+      return false;
+    }
+    if (!buffer_size) {
+      return true;
+    }
+    if (is_held_back(key) || buffer_size == POSITION_COMBO_BUFFER_SIZE) {
+      // Tapped before the combo completed, or too much to hold back.
+      resolve();
+      return process_position_combos(keycode, record);
+    }
+    buffer[buffer_size++] = *record;  // Release of an earlier key.
+    return false;
+  }
+
+  if (buffer_size) {
+    drop_expired(record->event.time);
+    const position_combo_mask_t combos = candidates & combos_at(key);
+    if (!combos || buffer_size == POSITION_COMBO_BUFFER_SIZE) {
+      // Continues no combo: settle the pending one, then start over.
+      resolve();
+      return process_position_combos(keycode, record);
+    }
+    hold_back(record, combos);
+    return false;
+  }
+
+  const position_combo_mask_t combos = combos_at(key);
+  if (!combos || get_highest_layer(layer_state | default_layer_state) !=
+                     get_highest_layer(default_layer_state)) {
+    return true;  // Not in a combo, nothing to hold back.
+  }
+  start_time = record->event.time;
+  hold_back(record, combos);
+  return false;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file position_combos.h
+ * @brief Position combos: combos matched on matrix positions.
+ *
+ * QMK's combos hold back every press of a key that is part of a combo for
+ * the whole `COMBO_TERM`, and check all combos on every key event. Here the
+ * combos are declared in combos.txt next to keymap.c, which
+ * scripts/gen_combos.py compiles into an index of the combos each matrix
+ * position is part of (combo_table.h). With it:
+ *
+ *  * a key that is in no combo is never held back,
+ *  * while keys are held back, the candidates are the combos that contain
+ *    all of them, a bitmask narrowed down with each press,
+ *  * a combo fires as soon as all its keys are down and no longer candidate
+ *    can still complete,
+ *  * the held back keys go out as normal presses as soon as no candidate is
+ *    left: on a press of another key, on a release, or when the terms of the
+ *    candidates run out. Every combo has its own term.
+ *
+ * The combo's keycode is sent as a `COMBO_EVENT` record through
+ * `process_record_user()`, and released when the first of its keys is.
+ * Combos only start on the default layer, where combos.txt looks up its keys.
+ *
+ * Call `process_position_combos()` from `pre_process_record_user()`, which
+ * runs before tap-hold keys are resolved. Its term timeouts run on the
+ * scheduler, see features/scheduler.h.
+ *
+ * Enable with `POSITION_COMBOS_ENABLE = yes` in rules.mk, which replaces QMK's
+ * combos (`COMBO_ENABLE`).
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef POSITION_COMBOS_ENABLE
+#include "combo_table.h"
+#endif  // POSITION_COMBOS_ENABLE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef COMBO_TERM
+#define COMBO_TERM 50
+#endif  // COMBO_TERM
+
+// Key events that can be held back while a combo is pending.
+#ifndef POSITION_COMBO_BUFFER_SIZE
+#define POSITION_COMBO_BUFFER_SIZE 8
+#endif  // POSITION_COMBO_BUFFER_SIZE
+
+#ifdef POSITION_COMBOS_ENABLE
+
+/** Handler function for position combos. */
+bool process_position_combos(uint16_t keycode, keyrecord_t* record);
+
+/** Whether the key at `key` is part of a combo and may be held back. */
+bool position_combo_key(keypos_t key);
+
+/** Whether the keys at `a` and `b` are both part of some combo. */
+bool position_combo_pair(keypos_t a, keypos_t b);
+
+#else
+
+static inline bool process_position_combos(uint16_t keycode,
+                                           keyrecord_t* record) {
+  return true;
+}
+static inline bool position_combo_key(keypos_t key) { return false; }
+static inline bool position_combo_pair(keypos_t a, keypos_t b) {
+  return false;
+}
+
+#endif  // POSITION_COMBOS_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file report_coalesce.c
+ * @brief Report coalescing implementation
+ */
+
+#include "report_coalesce.h"
+
+#include <string.h>
+
+#include "driver_wrap.h"
+
+static driver_wrap_t wrap;
+
+static report_keyboard_t last_sent;
+static report_keyboard_t pending;
+static bool has_pending = false;
+
+static uint32_t requested = 0;
+static uint32_t sent = 0;
+
+static void flush(void) {
+  if (!has_pending) {
+    return;
+  }
+  has_pending = false;
+  if (!memcmp(&pending, &last_sent, sizeof(pending))) {
+    return;
+  }
+  last_sent = pending;
+  ++sent;
+  wrap.send_keyboard(&pending);
+}
+
+static void send_keyboard(report_keyboard_t* report) {
+  ++requested;
+  if (has_pending && !driver_wrap_can_merge(&last_sent, &pending, report)) {
+    flush();
+  }
+  pending = *report;
+  has_pending = true;
+}
+
+void report_coalesce_task(void) {
+  if (driver_wrap_keyboard(&wrap, send_keyboard)) {
+    memset(&last_sent, 0, sizeof(last_sent));
+    has_pending = false;
+  }
+  flush();
+}
+
+void report_coalesce_print(void) {
+  uprintf("reports %lu, sent %lu, saved %lu (%lu%%)\n",
+          (unsigned long)requested, (unsigned long)sent,
+          (unsigned long)(requested - sent),
+          (unsigned long)(requested ? (requested - sent) * 100 / requested
+                                    : 0));
+}
+
+void report_coalesce_reset(void) {
+  requested = 0;
+  sent = 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file report_coalesce.h
+ * @brief Report coalescing: keyboard reports go out once per scan.
+ *
+ * Every `register_code()`, `unregister_code()` and mods change sends a report
+ * of its own, so handlers like Alt-Tab window switching or clearing mods and
+ * caps spend several USB polling intervals on reports that the next one
+ * supersedes within the same scan. Here the driver is wrapped so that reports
+ * replace a pending one, which `report_coalesce_task()` sends at the end of
+ * the scan if it differs from the last report sent.
+ *
+ * A report is only sent early where merging it would lose something the host
+ * must see in order:
+ *
+ *   - a key or mod pressed since the last report sent is released again,
+ *   - a key or mod released since is pressed again,
+ *   - mods change after a key was pressed, which would apply to that key.
+ *
+ * so Alt, Alt+Tab, Alt, none becomes Alt+Tab, none. `report_coalesce_print()`
+ * prints how many reports were asked for and how many were sent.
+ *
+ * Call `report_coalesce_task()` from `housekeeping_task_user()`, which runs
+ * after the scan's key events.
+ *
+ * Enable with `REPORT_COALESCE_ENABLE = yes` in rules.mk.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef REPORT_COALESCE_ENABLE
+
+/** Sends the pending report. Call once per scan. */
+void report_coalesce_task(void);
+
+/** Prints reports asked for, sent and saved. */
+void report_coalesce_print(void);
+
+/** Clears the counts. */
+void report_coalesce_reset(void);
+
+#else
+
+static inline void report_coalesce_task(void) {}
+static inline void report_coalesce_print(void) {}
+static inline void report_coalesce_reset(void) {}
+
+#endif  // REPORT_COALESCE_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
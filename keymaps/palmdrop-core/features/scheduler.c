@@ -0,0 +1,147 @@
+/**
+ * @file scheduler.c
+ * @brief Scheduler implementation
+ */
+
+#include "scheduler.h"
+
+#if SCHEDULER_SLOTS < 1 || SCHEDULER_SLOTS > 254
+#error "scheduler: SCHEDULER_SLOTS must be between 1 and 254"
+#endif
+
+#define NOT_IN_HEAP 0xFF
+
+typedef struct {
+  uint32_t deadline;
+  scheduler_callback_t callback;  // NULL if the slot is free.
+  void* arg;
+} scheduler_slot_t;
+
+// Tokens are slot indices + 1. A slot is in use from scheduling until its
+// callback returns 0 or it is cancelled, and pending while it is in the heap.
+static scheduler_slot_t slots[SCHEDULER_SLOTS];
+static uint8_t position[SCHEDULER_SLOTS];  // Index in heap, or NOT_IN_HEAP.
+static uint8_t heap[SCHEDULER_SLOTS];      // Pending slots, min-heap.
+static uint8_t heap_size = 0;
+// Deadline of heap[0], cached so that the idle check touches no other state.
+static uint32_t next_deadline = 0;
+// Slot whose callback is running, and whether it cancelled itself.
+static uint8_t running = NOT_IN_HEAP;
+static bool running_cancelled = false;
+
+// Deadlines compare modulo 2^32, so they must be within 24 days of each other.
+static bool before(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+
+static void heap_set(uint8_t index, uint8_t slot) {
+  heap[index] = slot;
+  position[slot] = index;
+}
+
+static void sift_up(uint8_t index) {
+  const uint8_t slot = heap[index];
+  while (index > 0) {
+    const uint8_t parent = (index - 1) / 2;
+    if (!before(slots[slot].deadline, slots[heap[parent]].deadline)) {
+      break;
+    }
+    heap_set(index, heap[parent]);
+    index = parent;
+  }
+  heap_set(index, slot);
+}
+
+static void sift_down(uint8_t index) {
+  const uint8_t slot = heap[index];
+  for (;;) {
+    uint8_t child = 2 * index + 1;
+    if (child >= heap_size) {
+      break;
+    }
+    if (child + 1 < heap_size &&
+        before(slots[heap[child + 1]].deadline, slots[heap[child]].deadline)) {
+      ++child;
+    }
+    if (!before(slots[heap[child]].deadline, slots[slot].deadline)) {
+      break;
+    }
+    heap_set(index, heap[child]);
+    index = child;
+  }
+  heap_set(index, slot);
+}
+
+static void heap_push(uint8_t slot) {
+  heap_set(heap_size++, slot);
+  sift_up(heap_size - 1);
+  next_deadline = slots[heap[0]].deadline;
+}
+
+static void heap_remove(uint8_t index) {
+  position[heap[index]] = NOT_IN_HEAP;
+  if (index != --heap_size) {
+    heap_set(index, heap[heap_size]);
+    sift_down(index);
+    sift_up(index);
+  }
+  if (heap_size) {
+    next_deadline = slots[heap[0]].deadline;
+  }
+}
+
+scheduler_token_t scheduler_at(uint32_t deadline,
+                               scheduler_callback_t callback, void* arg) {
+  for (uint8_t slot = 0; slot < SCHEDULER_SLOTS; ++slot) {
+    if (!slots[slot].callback) {
+      slots[slot] = (scheduler_slot_t){deadline, callback, arg};
+      heap_push(slot);
+      return slot + 1;
+    }
+  }
+  return SCHEDULER_NO_TOKEN;
+}
+
+scheduler_token_t scheduler_defer(uint32_t delay,
+                                  scheduler_callback_t callback, void* arg) {
+  return scheduler_at(timer_read32() + delay, callback, arg);
+}
+
+bool scheduler_cancel(scheduler_token_t token) {
+  if (token == SCHEDULER_NO_TOKEN || token > SCHEDULER_SLOTS) {
+    return false;
+  }
+  const uint8_t slot = token - 1;
+  if (slot == running) {
+    // Keep the slot until the callback returns so it isn't handed out again.
+    const bool pending = !running_cancelled;
+    running_cancelled = true;
+    return pending;
+  }
+  if (position[slot] == NOT_IN_HEAP || !slots[slot].callback) {
+    return false;
+  }
+  heap_remove(position[slot]);
+  slots[slot].callback = NULL;
+  return true;
+}
+
+void scheduler_task(void) {
+  if (heap_size == 0 || !timer_expired32(timer_read32(), next_deadline)) {
+    return;
+  }
+
+  const uint32_t now = timer_read32();
+  while (heap_size && !before(now, next_deadline)) {
+    const uint8_t slot = heap[0];
+    heap_remove(0);
+    running = slot;
+    running_cancelled = false;
+    const uint32_t delay = slots[slot].callback(now, slots[slot].arg);
+    running = NOT_IN_HEAP;
+    if (delay && !running_cancelled) {
+      slots[slot].deadline = now + delay;
+      heap_push(slot);
+    } else {
+      slots[slot].callback = NULL;
+    }
+  }
+}
@@ -0,0 +1,82 @@
+/**
+ * @file scheduler.h
+ * @brief Scheduler: deferred callbacks for feature timeouts.
+ *
+ * Features with timeouts used to each poll their own timer from
+ * `matrix_scan_user()`, so every armed or unarmed timeout cost a compare on
+ * every scan. Instead, features schedule a callback for their deadline:
+ *
+ *     static uint32_t idle_callback(uint32_t now, void* arg) {
+ *       // Do the timeout work...
+ *       return 0;  // Or the delay in ms until the callback should run again.
+ *     }
+ *
+ *     token = scheduler_defer(IDLE_TIMEOUT, idle_callback, NULL);
+ *
+ * and `scheduler_task()`, called from `matrix_scan_user()`, runs callbacks
+ * whose deadline has passed. Pending callbacks are kept in a binary min-heap
+ * ordered by deadline, so when nothing is due the task only compares the clock
+ * against the earliest deadline, however many callbacks are pending.
+ *
+ * Timeouts that are pushed back on every key press shouldn't reschedule on
+ * the hot path. Store the time of the last press instead and let the callback
+ * return the remaining delay when it runs early:
+ *
+ *     static uint32_t last_press = 0;
+ *
+ *     static uint32_t idle_callback(uint32_t now, void* arg) {
+ *       if (now - last_press < IDLE_TIMEOUT) {
+ *         return IDLE_TIMEOUT - (now - last_press);  // Not idle yet.
+ *       }
+ *       // Timed out...
+ *       return 0;
+ *     }
+ *
+ * A token stays valid until its callback returns 0 or it is cancelled, after
+ * which it may be handed out again. Callbacks may schedule and cancel other
+ * callbacks, and cancel themselves.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of pending callbacks.
+#ifndef SCHEDULER_SLOTS
+#define SCHEDULER_SLOTS 4
+#endif  // SCHEDULER_SLOTS
+
+/** Identifies a scheduled callback, `SCHEDULER_NO_TOKEN` if none. */
+typedef uint8_t scheduler_token_t;
+#define SCHEDULER_NO_TOKEN 0
+
+/**
+ * Deferred callback, called with the current time and the `arg` it was
+ * scheduled with. Returns the delay in ms until it runs again, or 0 to stop.
+ */
+typedef uint32_t (*scheduler_callback_t)(uint32_t now, void* arg);
+
+/**
+ * Runs `callback` once `deadline` (in `timer_read32()` time) has passed.
+ * Returns its token, or `SCHEDULER_NO_TOKEN` if all slots are in use.
+ */
+scheduler_token_t scheduler_at(uint32_t deadline,
+                               scheduler_callback_t callback, void* arg);
+
+/** Runs `callback` `delay` ms from now, see `scheduler_at()`. */
+scheduler_token_t scheduler_defer(uint32_t delay,
+                                  scheduler_callback_t callback, void* arg);
+
+/** Cancels a pending callback. Returns false if `token` wasn't pending. */
+bool scheduler_cancel(scheduler_token_t token);
+
+/** Runs the callbacks that are due. Call from `matrix_scan_user()`. */
+void scheduler_task(void);
+
+#ifdef __cplusplus
+}
+#endif
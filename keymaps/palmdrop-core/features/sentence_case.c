@@ -24,6 +24,9 @@
 
 #include <string.h>
 
+#include "scheduler.h"
+#include "trace_buffer.h"
+
 #if !defined(IS_QK_MOD_TAP)
 // Attempt to detect out-of-date QMK installation, which would fail with
 // implicit-function-declaration errors in the code below.
@@ -38,6 +41,16 @@
 // Number of keys of state history to retain for backspacing.
 #define STATE_HISTORY_SIZE 6
 
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+// Abbreviation trie generated by scripts/gen_abbreviations.py.
+#include "sentence_case_abbreviations.h"
+
+// Trie node while typing a word that can't be an abbreviation.
+#define TRIE_NONE 0xFFFF
+// Trie node at the start of a word.
+#define TRIE_ROOT 0
+#endif  // SENTENCE_CASE_ABBREVIATIONS
+
 // clang-format off
 /** States in matching the beginning of a sentence. */
 enum {
@@ -47,29 +60,62 @@ enum {
   STATE_ENDING,   /**< Sentence ended. */
   STATE_PRIMED,   /**< "Primed" state, in the space following an ending. */
   STATE_DISABLED, /**< Sentence Case is disabled. */
+  NUM_STATES,
+};
+// clang-format on
+
+// Flags of a transition, above the next state.
+#define TRANSITION_STATE_MASK 0x0F
+// Go to the next state only if this is a real sentence ending, else STATE_INIT.
+#define TRANSITION_CHECK 0x10
+// Start of a sentence: capitalize the key, unless it was just suppressed.
+#define TRANSITION_CAPITALIZE 0x20
+// Space after a sentence ending: stop suppressing.
+#define TRANSITION_PRIME 0x40
+
+#define NUM_COLUMNS (SENTENCE_CASE_SYMBOL - SENTENCE_CASE_LETTER + 1)
+#define COLUMN(key_class) ((key_class) - SENTENCE_CASE_LETTER)
+
+// We search for sentence beginnings using a simple finite state machine. It
+// matches things like "a. a" and "a.  a" but not "a.. a" or "a.a. a".
+// clang-format off
+static const uint8_t PROGMEM transitions[NUM_STATES][NUM_COLUMNS] = {
+  //                  'a'                                 '.'                              ' '                              '\''            '#'
+  [STATE_INIT]     = {STATE_WORD,                         STATE_ABBREV,                    STATE_INIT,                      STATE_INIT,     STATE_INIT},
+  [STATE_WORD]     = {STATE_WORD,                         STATE_ENDING | TRANSITION_CHECK, STATE_INIT,                      STATE_WORD,     STATE_INIT},
+  [STATE_ABBREV]   = {STATE_ABBREV,                       STATE_ABBREV,                    STATE_INIT,                      STATE_ABBREV,   STATE_INIT},
+  [STATE_ENDING]   = {STATE_ABBREV,                       STATE_ABBREV,                    STATE_PRIMED | TRANSITION_PRIME, STATE_ENDING,   STATE_INIT},
+  [STATE_PRIMED]   = {STATE_WORD | TRANSITION_CAPITALIZE, STATE_ABBREV,                    STATE_PRIMED | TRANSITION_PRIME, STATE_PRIMED,   STATE_INIT},
+  // Never looked up, keys are not processed while disabled.
+  [STATE_DISABLED] = {STATE_DISABLED,                     STATE_DISABLED,                  STATE_DISABLED,                  STATE_DISABLED, STATE_DISABLED},
 };
 // clang-format on
 
 #if SENTENCE_CASE_TIMEOUT > 0
-static uint16_t idle_timer = 0;
+// Time of the last key press, and the idle callback while one is pending.
+static uint32_t idle_timer = 0;
+static scheduler_token_t idle_token = SCHEDULER_NO_TOKEN;
 #endif  // SENTENCE_CASE_TIMEOUT > 0
+// key_buffer, state_history and trie_history are circular buffers. The head
+// index points at the oldest entry, which is the next one overwritten.
 #if SENTENCE_CASE_BUFFER_SIZE > 1
 static uint16_t key_buffer[SENTENCE_CASE_BUFFER_SIZE] = {0};
+static uint8_t key_head = 0;
 #endif  // SENTENCE_CASE_BUFFER_SIZE > 1
 static uint8_t state_history[STATE_HISTORY_SIZE];
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+static uint16_t trie_history[STATE_HISTORY_SIZE];
+static uint16_t trie_node = TRIE_ROOT;
+#endif  // SENTENCE_CASE_ABBREVIATIONS
+static uint8_t history_head = 0;
 static uint16_t suppress_key = KC_NO;
 static uint8_t sentence_state = STATE_INIT;
 
 // Sets the current state to `new_state`.
 static void set_sentence_state(uint8_t new_state) {
-#ifndef NO_DEBUG
-  if (debug_enable && sentence_state != new_state) {
-    static const char* state_names[] = {
-        "INIT", "WORD", "ABBREV", "ENDING", "PRIMED", "DISABLED",
-    };
-    dprintf("Sentence case: %s\n", state_names[new_state]);
+  if (sentence_state != new_state) {
+    TRACE(SENTENCE_CASE_STATE, new_state, 0, 0);
   }
-#endif  // NO_DEBUG
 
   const bool primed = (new_state == STATE_PRIMED);
   if (primed != (sentence_state == STATE_PRIMED)) {
@@ -80,9 +126,16 @@ static void set_sentence_state(uint8_t new_state) {
 
 static void clear_state_history(void) {
 #if SENTENCE_CASE_TIMEOUT > 0
-  idle_timer = 0;
+  scheduler_cancel(idle_token);
+  idle_token = SCHEDULER_NO_TOKEN;
 #endif  // SENTENCE_CASE_TIMEOUT > 0
   memset(state_history, STATE_INIT, sizeof(state_history));
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+  for (uint8_t i = 0; i < STATE_HISTORY_SIZE; ++i) {
+    trie_history[i] = TRIE_NONE;
+  }
+  trie_node = TRIE_ROOT;
+#endif  // SENTENCE_CASE_ABBREVIATIONS
   if (sentence_state != STATE_DISABLED) {
     set_sentence_state(STATE_INIT);
   }
@@ -96,6 +149,50 @@ void sentence_case_clear(void) {
 #endif  // SENTENCE_CASE_BUFFER_SIZE > 1
 }
 
+#if SENTENCE_CASE_BUFFER_SIZE > 1
+// Returns the key buffer unrolled oldest first, as
+// `sentence_case_check_ending()` expects it.
+static const uint16_t* ordered_key_buffer(void) {
+  static uint16_t ordered[SENTENCE_CASE_BUFFER_SIZE];
+  uint8_t i = key_head;
+  for (uint8_t j = 0; j < SENTENCE_CASE_BUFFER_SIZE; ++j) {
+    ordered[j] = key_buffer[i];
+    if (++i == SENTENCE_CASE_BUFFER_SIZE) {
+      i = 0;
+    }
+  }
+  return ordered;
+}
+#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
+
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+// Follows the edge labeled `keycode` out of `node`. The number of edges is
+// bounded by the number of letters, so this doesn't depend on the size of the
+// dictionary.
+static uint16_t trie_next(uint16_t node, uint16_t keycode) {
+  if (node == TRIE_NONE || keycode > 0xFF) {
+    return TRIE_NONE;
+  }
+  const uint16_t end = pgm_read_word(&sentence_case_trie_edges[node + 1]);
+  for (uint16_t e = pgm_read_word(&sentence_case_trie_edges[node]); e < end;
+       ++e) {
+    const uint8_t key = pgm_read_byte(&sentence_case_trie_keys[e]);
+    if (key == keycode) {
+      return e + 1;  // Edge e leads to node e + 1.
+    } else if (key > keycode) {
+      break;  // Edges are sorted by keycode.
+    }
+  }
+  return TRIE_NONE;
+}
+
+// Whether the word typed so far is one of the abbreviations.
+static bool trie_accepts(uint16_t node) {
+  return node != TRIE_NONE &&
+         (pgm_read_byte(&sentence_case_trie_accept[node / 8]) >> (node % 8)) & 1;
+}
+#endif  // SENTENCE_CASE_ABBREVIATIONS
+
 void sentence_case_on(void) {
   if (sentence_state == STATE_DISABLED) {
     sentence_state = STATE_INIT;
@@ -120,16 +217,22 @@ void sentence_case_toggle(void) {
 bool is_sentence_case_on(void) { return sentence_state != STATE_DISABLED; }
 
 #if SENTENCE_CASE_TIMEOUT > 0
-#if SENTENCE_CASE_TIMEOUT < 100 || SENTENCE_CASE_TIMEOUT > 30000
-// Constrain timeout to a sensible range. With the 16-bit timer, the longest
-// representable timeout is 32768 ms, rounded here to 30000 ms = half a minute.
-#error "sentence_case: SENTENCE_CASE_TIMEOUT must be between 100 and 30000 ms"
+#if SENTENCE_CASE_TIMEOUT < 100
+// Constrain timeout to a sensible range.
+#error "sentence_case: SENTENCE_CASE_TIMEOUT must be at least 100 ms"
 #endif
 
-void sentence_case_task(void) {
-  if (idle_timer && timer_expired(timer_read(), idle_timer)) {
-    clear_state_history();  // Timed out; clear all state.
+// Scheduled on the first key press after the state was cleared. Key presses
+// only update `idle_timer`, so this reschedules itself for the remaining time
+// until no key was pressed for the whole timeout.
+static uint32_t sentence_case_idle(uint32_t now, void* arg) {
+  const uint32_t idle = now - idle_timer;
+  if (idle < SENTENCE_CASE_TIMEOUT) {
+    return SENTENCE_CASE_TIMEOUT - idle;
   }
+  idle_token = SCHEDULER_NO_TOKEN;
+  clear_state_history();  // Timed out; clear all state.
+  return 0;
 }
 #endif  // SENTENCE_CASE_TIMEOUT > 0
 
@@ -140,7 +243,11 @@ bool process_sentence_case(uint16_t keycode, keyrecord_t* record) {
   }
 
 #if SENTENCE_CASE_TIMEOUT > 0
-  idle_timer = (record->event.time + SENTENCE_CASE_TIMEOUT) | 1;
+  idle_timer = timer_read32();
+  if (idle_token == SCHEDULER_NO_TOKEN) {
+    idle_token =
+        scheduler_defer(SENTENCE_CASE_TIMEOUT, sentence_case_idle, NULL);
+  }
 #endif  // SENTENCE_CASE_TIMEOUT > 0
 
   switch (keycode) {
@@ -172,108 +279,91 @@ bool process_sentence_case(uint16_t keycode, keyrecord_t* record) {
   }
 
   if (keycode == KC_BSPC) {
-    // Backspace key pressed. Rewind the state and key buffers.
-    set_sentence_state(state_history[STATE_HISTORY_SIZE - 1]);
-
-    memmove(state_history + 1, state_history, STATE_HISTORY_SIZE - 1);
-    state_history[0] = STATE_INIT;
+    // Backspace key pressed. Rewind the state and key buffers, freeing the
+    // newest entries to become the oldest.
+    history_head = (history_head ? history_head : STATE_HISTORY_SIZE) - 1;
+    set_sentence_state(state_history[history_head]);
+    state_history[history_head] = STATE_INIT;
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+    trie_node = trie_history[history_head];
+    trie_history[history_head] = TRIE_NONE;
+#endif  // SENTENCE_CASE_ABBREVIATIONS
 #if SENTENCE_CASE_BUFFER_SIZE > 1
-    memmove(key_buffer + 1, key_buffer,
-            (SENTENCE_CASE_BUFFER_SIZE - 1) * sizeof(uint16_t));
-    key_buffer[0] = KC_NO;
+    key_head = (key_head ? key_head : SENTENCE_CASE_BUFFER_SIZE) - 1;
+    key_buffer[key_head] = KC_NO;
 #endif  // SENTENCE_CASE_BUFFER_SIZE > 1
     return true;
   }
 
   const uint8_t mods = get_mods() | get_weak_mods() | get_oneshot_mods();
-  uint8_t new_state = STATE_INIT;
-
-  // We search for sentence beginnings using a simple finite state machine. It
-  // matches things like "a. a" and "a.  a" but not "a.. a" or "a.a. a". The
-  // state transition matrix is:
-  //
-  //             'a'       '.'      ' '      '\''
-  //           +-------------------------------------
-  //   INIT    | WORD      INIT     INIT     INIT
-  //   WORD    | WORD      ENDING   INIT     WORD
-  //   ABBREV  | ABBREV    ABBREV   INIT     ABBREV
-  //   ENDING  | ABBREV    INIT     PRIMED   ENDING
-  //   PRIMED  | match!    INIT     PRIMED   PRIMED
-  char code = sentence_case_press_user(keycode, record, mods);
-  dprintf("Sentence Case: code = '%c' (%d)\n", code, (int)code);
+  const char code = sentence_case_press_user(keycode, record, mods);
+  TRACE(SENTENCE_CASE_CODE, code, keycode, 0);
+  uint8_t key_class;
   switch (code) {
     case '\0':  // Current key should be ignored.
       return true;
-
-    case 'a':  // Current key is a letter.
-      switch (sentence_state) {
-        case STATE_ABBREV:
-        case STATE_ENDING:
-          new_state = STATE_ABBREV;
-          break;
-
-        case STATE_PRIMED:
-          // This is the start of a sentence.
-          if (keycode != suppress_key) {
-            suppress_key = keycode;
-            set_oneshot_mods(MOD_BIT(KC_LSFT));  // Shift mod to capitalize.
-            new_state = STATE_WORD;
-          }
-          break;
-
-        default:
-          new_state = STATE_WORD;
-      }
+    case 'a':
+      key_class = SENTENCE_CASE_LETTER;
       break;
-
-    case '.':  // Current key is sentence-ending punctuation.
-      switch (sentence_state) {
-        case STATE_WORD:
-          new_state = STATE_ENDING;
-          break;
-
-        default:
-          new_state = STATE_ABBREV;
-      }
+    case '.':
+      key_class = SENTENCE_CASE_PUNCT;
       break;
-
-    case ' ':  // Current key is a space.
-      if (sentence_state == STATE_PRIMED ||
-          (sentence_state == STATE_ENDING
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-           && sentence_case_check_ending(key_buffer)
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
-               )) {
-        new_state = STATE_PRIMED;
-        suppress_key = KC_NO;
-      }
+    case ' ':
+      key_class = SENTENCE_CASE_SPACE;
       break;
-
-    case '\'':  // Current key is a quote.
-      new_state = sentence_state;
+    case '\'':
+      key_class = SENTENCE_CASE_QUOTE;
       break;
+    default:
+      key_class = SENTENCE_CASE_SYMBOL;
   }
 
-    // Slide key_buffer and state_history buffers one element to the left.
-    // Optimization note: Using manual loops instead of memmove() here saved
-    // ~100 bytes on AVR.
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-  for (int8_t i = 0; i < SENTENCE_CASE_BUFFER_SIZE - 1; ++i) {
-    key_buffer[i] = key_buffer[i + 1];
-  }
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
-  for (int8_t i = 0; i < STATE_HISTORY_SIZE - 1; ++i) {
-    state_history[i] = state_history[i + 1];
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+  // Abbreviations are matched one key at a time from the start of the word.
+  const uint16_t prev_trie_node = trie_node;
+  trie_node = (key_class == SENTENCE_CASE_LETTER ||
+               key_class == SENTENCE_CASE_PUNCT)
+                  ? trie_next(trie_node, keycode)
+                  : TRIE_ROOT;
+#endif  // SENTENCE_CASE_ABBREVIATIONS
+
+  const uint8_t transition =
+      pgm_read_byte(&transitions[sentence_state][COLUMN(key_class)]);
+  uint8_t new_state = transition & TRANSITION_STATE_MASK;
+
+  if (transition & TRANSITION_CAPITALIZE) {
+    if (keycode != suppress_key) {
+      suppress_key = keycode;
+      set_oneshot_mods(MOD_BIT(KC_LSFT));  // Shift mod to capitalize.
+    } else {
+      new_state = STATE_INIT;
+    }
+  } else if (transition & TRANSITION_PRIME) {
+    suppress_key = KC_NO;
   }
 
+#ifdef SENTENCE_CASE_ABBREVIATIONS
+  if ((transition & TRANSITION_CHECK) && trie_accepts(trie_node)) {
+    TRACE(SENTENCE_CASE_NOT_END, 0, keycode, 0);
+    new_state = STATE_INIT;
+  }
+  trie_history[history_head] = prev_trie_node;
+#endif  // SENTENCE_CASE_ABBREVIATIONS
 #if SENTENCE_CASE_BUFFER_SIZE > 1
-  key_buffer[SENTENCE_CASE_BUFFER_SIZE - 1] = keycode;
-  if (new_state == STATE_ENDING && !sentence_case_check_ending(key_buffer)) {
-    dprintf("Not a real ending.\n");
+  key_buffer[key_head] = keycode;
+  if (++key_head == SENTENCE_CASE_BUFFER_SIZE) {
+    key_head = 0;
+  }
+  if ((transition & TRANSITION_CHECK) && new_state != STATE_INIT &&
+      !sentence_case_check_ending(ordered_key_buffer())) {
+    TRACE(SENTENCE_CASE_NOT_END, 0, keycode, 0);
     new_state = STATE_INIT;
   }
 #endif  // SENTENCE_CASE_BUFFER_SIZE > 1
-  state_history[STATE_HISTORY_SIZE - 1] = sentence_state;
+  state_history[history_head] = sentence_state;
+  if (++history_head == STATE_HISTORY_SIZE) {
+    history_head = 0;
+  }
 
   set_sentence_state(new_state);
   return true;
@@ -295,45 +385,54 @@ bool sentence_case_just_typed_P(const uint16_t* buffer, const uint16_t* pattern,
 }
 
 __attribute__((weak)) bool sentence_case_check_ending(const uint16_t* buffer) {
-#if SENTENCE_CASE_BUFFER_SIZE >= 5
+#if SENTENCE_CASE_BUFFER_SIZE >= 5 && !defined(SENTENCE_CASE_ABBREVIATIONS)
   // Don't consider the abbreviations "vs." and "etc." to end the sentence.
   if (SENTENCE_CASE_JUST_TYPED(KC_SPC, KC_V, KC_S, KC_DOT) ||
       SENTENCE_CASE_JUST_TYPED(KC_SPC, KC_E, KC_T, KC_C, KC_DOT)) {
     return false;  // Not a real sentence ending.
   }
-#endif  // SENTENCE_CASE_BUFFER_SIZE >= 5
+#endif  // SENTENCE_CASE_BUFFER_SIZE >= 5 && !SENTENCE_CASE_ABBREVIATIONS
   return true;  // Real sentence ending; capitalize next letter.
 }
 
+__attribute__((weak)) const uint8_t PROGMEM
+    sentence_case_classes[SENTENCE_CASE_CLASSES_SIZE] = {
+        SENTENCE_CASE_DEFAULT_CLASSES,
+};
+
+uint8_t sentence_case_keycode_class(uint16_t keycode, uint8_t mods) {
+  if (IS_QK_MODS(keycode)) {
+    // Look up e.g. S(KC_1) as KC_1 typed with shift.
+    const uint8_t keycode_mods = QK_MODS_GET_MODS(keycode);
+    mods |= (keycode_mods & 0x10) ? (keycode_mods & 0x0F) << 4 : keycode_mods;
+    keycode = QK_MODS_GET_BASIC_KEYCODE(keycode);
+  }
+  if ((mods & ~(MOD_MASK_SHIFT | MOD_BIT(KC_RALT))) != 0) {
+    return SENTENCE_CASE_CLEAR;
+  } else if (keycode >= SENTENCE_CASE_CLASSES_SIZE) {
+    return IS_MODIFIER_KEYCODE(keycode) ? SENTENCE_CASE_IGNORE
+                                        : SENTENCE_CASE_CLEAR;
+  }
+  const uint8_t entry = pgm_read_byte(&sentence_case_classes[keycode]);
+  return (mods & MOD_MASK_SHIFT) ? entry >> 4 : entry & 0x0F;
+}
+
 __attribute__((weak)) char sentence_case_press_user(uint16_t keycode,
                                                     keyrecord_t* record,
                                                     uint8_t mods) {
-  if ((mods & ~(MOD_MASK_SHIFT | MOD_BIT(KC_RALT))) == 0) {
-    const bool shifted = mods & MOD_MASK_SHIFT;
-    switch (keycode) {
-      case KC_LCTL ... KC_RGUI:  // Mod keys.
-        return '\0';  // These keys are ignored.
-
-      case KC_A ... KC_Z:
-        return 'a';  // Letter key.
-
-      case KC_DOT:  // . is punctuation, Shift . is a symbol (>)
-        return !shifted ? '.' : '#';
-      case KC_1:
-      case KC_SLSH:
-        return shifted ? '.' : '#';
-      case KC_2 ... KC_0:  // 2 3 4 5 6 7 8 9 0
-      case KC_MINS ... KC_SCLN:  // - = [ ] ; backslash
-      case KC_GRV:
-      case KC_COMM:
-        return '#';  // Symbol key.
-
-      case KC_SPC:
-        return ' ';  // Space key.
-
-      case KC_QUOT:
-        return '\'';  // Quote key.
-    }
+  switch (sentence_case_keycode_class(keycode, mods)) {
+    case SENTENCE_CASE_LETTER:
+      return 'a';
+    case SENTENCE_CASE_PUNCT:
+      return '.';
+    case SENTENCE_CASE_SPACE:
+      return ' ';
+    case SENTENCE_CASE_QUOTE:
+      return '\'';
+    case SENTENCE_CASE_SYMBOL:
+      return '#';
+    case SENTENCE_CASE_IGNORE:
+      return '\0';
   }
 
   // Otherwise clear Sentence Case to initial state.
@@ -37,6 +37,18 @@
  * detected as not real sentence endings. You can use the callback
  * `sentence_case_check_ending()` to define other exceptions.
  *
+ * For long lists of exceptions, define `SENTENCE_CASE_ABBREVIATIONS` in
+ * config.h and list them in abbreviations.txt next to keymap.c. The list is
+ * compiled by scripts/gen_abbreviations.py into a trie in PROGMEM, which is
+ * walked one key at a time as words are typed, so the cost per key does not
+ * depend on the number of abbreviations. "vs." and "etc." must then be listed
+ * too.
+ *
+ * Define `SENTENCE_CASE_TIMEOUT` in config.h to clear the state after that
+ * many milliseconds without key presses. The timeout runs on the scheduler,
+ * so it needs features/scheduler.c and `scheduler_task()` in
+ * `matrix_scan_user()`, see features/scheduler.h.
+ *
  * @note One-shot keys must be enabled.
  *
  * For full documentation, see
@@ -58,26 +70,74 @@ extern "C" {
 #define SENTENCE_CASE_BUFFER_SIZE 8
 #endif  // SENTENCE_CASE_BUFFER_SIZE
 
+/** How Sentence Case interprets a key, see `sentence_case_press_user()`. */
+enum sentence_case_class {
+  SENTENCE_CASE_CLEAR,  /**< Clear to initial state. Default for unlisted keys. */
+  SENTENCE_CASE_IGNORE, /**< '\0' Ignore the key, e.g. mod keys. */
+  SENTENCE_CASE_LETTER, /**< 'a' Letter. */
+  SENTENCE_CASE_PUNCT,  /**< '.' Sentence-ending punctuation. */
+  SENTENCE_CASE_SPACE,  /**< ' ' Space. */
+  SENTENCE_CASE_QUOTE,  /**< '\'' Quote or double quote. */
+  SENTENCE_CASE_SYMBOL, /**< '#' Other backspaceable character. */
+};
+
+// Size of `sentence_case_classes`. By default it covers the basic keycodes up
+// to KC_SLSH, which includes all printable keys of common layouts.
+#ifndef SENTENCE_CASE_CLASSES_SIZE
+#define SENTENCE_CASE_CLASSES_SIZE (KC_SLSH + 1)
+#endif  // SENTENCE_CASE_CLASSES_SIZE
+
 /**
- * Handler function for Sentence Case.
+ * Entry of `sentence_case_classes`: the class of a key when typed without and
+ * with shift, e.g. `SENTENCE_CASE_CLASS(PUNCT, SYMBOL)` for ". >".
+ */
+#define SENTENCE_CASE_CLASS(unshifted, shifted) \
+  (SENTENCE_CASE_##unshifted | SENTENCE_CASE_##shifted << 4)
+
+/** Default entries of `sentence_case_classes`, for a US host layout. */
+// clang-format off
+#define SENTENCE_CASE_DEFAULT_CLASSES                          \
+  [KC_A ... KC_Z] = SENTENCE_CASE_CLASS(LETTER, LETTER),       \
+  [KC_DOT] = SENTENCE_CASE_CLASS(PUNCT, SYMBOL),               \
+  [KC_1] = SENTENCE_CASE_CLASS(SYMBOL, PUNCT),                 \
+  [KC_SLSH] = SENTENCE_CASE_CLASS(SYMBOL, PUNCT),              \
+  [KC_2 ... KC_0] = SENTENCE_CASE_CLASS(SYMBOL, SYMBOL),       \
+  [KC_MINS ... KC_SCLN] = SENTENCE_CASE_CLASS(SYMBOL, SYMBOL), \
+  [KC_GRV] = SENTENCE_CASE_CLASS(SYMBOL, SYMBOL),              \
+  [KC_COMM] = SENTENCE_CASE_CLASS(SYMBOL, SYMBOL),             \
+  [KC_SPC] = SENTENCE_CASE_CLASS(SPACE, SPACE),                \
+  [KC_QUOT] = SENTENCE_CASE_CLASS(QUOTE, QUOTE)
+// clang-format on
+
+/**
+ * Optional table with the class of every basic keycode, in PROGMEM.
  *
- * Call this function from `process_record_user()` to implement Sentence Case.
+ * Used by the default `sentence_case_press_user()`. Modified keycodes like
+ * `S(KC_1)` are looked up as their basic keycode with the mods applied, so
+ * layout-specific keycodes like `SE_QUES` need no entries of their own. To
+ * customize, define the table in keymap.c, listing keys declaratively:
+ *
+ *     const uint8_t PROGMEM sentence_case_classes[SENTENCE_CASE_CLASSES_SIZE] = {
+ *         SENTENCE_CASE_DEFAULT_CLASSES,
+ *         [KC_NUHS] = SENTENCE_CASE_CLASS(QUOTE, QUOTE),
+ *     };
  */
-bool process_sentence_case(uint16_t keycode, keyrecord_t* record);
+extern const uint8_t sentence_case_classes[SENTENCE_CASE_CLASSES_SIZE];
 
 /**
- * @fn sentence_case_task(void)
- * Matrix task function for Sentence Case.
+ * Looks up the class of `keycode` with `mods` in `sentence_case_classes`.
  *
- * If using `SENTENCE_CASE_TIMEOUT`, call this function from your
- * `matrix_scan_user()` function in keymap.c. (If no timeout is set, calling
- * `sentence_case_task()` has no effect.)
+ * Mod keys are SENTENCE_CASE_IGNORE. Keys pressed with mods other than shift
+ * and AltGr, and keys outside the table, are SENTENCE_CASE_CLEAR.
  */
-#if SENTENCE_CASE_TIMEOUT > 0
-void sentence_case_task(void);
-#else
-static inline void sentence_case_task(void) {}
-#endif
+uint8_t sentence_case_keycode_class(uint16_t keycode, uint8_t mods);
+
+/**
+ * Handler function for Sentence Case.
+ *
+ * Call this function from `process_record_user()` to implement Sentence Case.
+ */
+bool process_sentence_case(uint16_t keycode, keyrecord_t* record);
 
 void sentence_case_on(void); /**< Enables Sentence Case. */
 void sentence_case_off(void); /**< Disables Sentence Case. */
@@ -104,7 +164,8 @@ void sentence_case_primed(bool primed);
  * of the last SENTENCE_CASE_BUFFER_SIZE keycodes. Returning true means it is a
  * real sentence ending; returning false means it is not.
  *
- * The default implementation checks for the abbreviations "vs." and "etc.":
+ * Without `SENTENCE_CASE_ABBREVIATIONS`, the default implementation checks for
+ * the abbreviations "vs." and "etc.", otherwise it always returns true:
  *
  *     bool sentence_case_check_ending(const uint16_t* buffer) {
  *       // Don't consider "vs." and "etc." to end the sentence.
@@ -169,47 +230,25 @@ bool sentence_case_just_typed_P(const uint16_t* buffer, const uint16_t* pattern,
  * action that backspace doesn't undo), then the callback should call
  * `sentence_case_clear()` to clear the state and then return '\0'.
  *
- * The default callback is:
+ * The default callback looks up the key in `sentence_case_classes`, so for
+ * most layouts it's enough to customize that table:
  *
  *     char sentence_case_press_user(uint16_t keycode,
  *                                   keyrecord_t* record,
  *                                   uint8_t mods) {
- *       if ((mods & ~(MOD_MASK_SHIFT | MOD_BIT(KC_RALT))) == 0) {
- *         const bool shifted = mods & MOD_MASK_SHIFT;
- *         switch (keycode) {
- *           case KC_LCTL ... KC_RGUI:  // Mod keys.
- *             return '\0';  // These keys are ignored.
- *
- *           case KC_A ... KC_Z:
- *             return 'a';  // Letter key.
- *
- *           case KC_DOT:  // . is punctuation, Shift . is a symbol (>)
- *             return !shifted ? '.' : '#';
- *           case KC_1:
- *           case KC_SLSH:
- *             return shifted ? '.' : '#';
- *           case KC_2 ... KC_0:  // 2 3 4 5 6 7 8 9 0
- *           case KC_MINS ... KC_SCLN:  // - = [ ] ; backslash
- *           case KC_GRV:
- *           case KC_COMM:
- *             return '#';  // Symbol key.
- *
- *           case KC_SPC:
- *             return ' ';  // Space key.
- *
- *           case KC_QUOT:
- *             return '\'';  // Quote key.
- *         }
+ *       switch (sentence_case_keycode_class(keycode, mods)) {
+ *         case SENTENCE_CASE_LETTER: return 'a';
+ *         case SENTENCE_CASE_PUNCT: return '.';
+ *         case SENTENCE_CASE_SPACE: return ' ';
+ *         case SENTENCE_CASE_QUOTE: return '\'';
+ *         case SENTENCE_CASE_SYMBOL: return '#';
+ *         case SENTENCE_CASE_IGNORE: return '\0';
  *       }
- *
  *       // Otherwise clear Sentence Case to initial state.
  *       sentence_case_clear();
  *       return '\0';
  *     }
  *
- * To customize, copy the above function into your keymap and add/remove
- * keycodes to the above cases.
- *
  * @param keycode Current keycode.
  * @param record record_t for the current press event.
  * @param mods equal to `get_mods() | get_weak_mods() | get_oneshot_mods()`
@@ -0,0 +1,134 @@
+/**
+ * @file speculative_tap.c
+ * @brief Speculative tap implementation
+ */
+
+#include "speculative_tap.h"
+
+#include "trace_buffer.h"
+
+#if !defined(REPEAT_KEY_ENABLE) && !defined(COMBO_ENABLE)
+#error "speculative_tap: needs REPEAT_KEY_ENABLE or COMBO_ENABLE"
+#endif
+
+// A speculated key while it is held, with what tapping would have seen.
+typedef struct {
+  keyrecord_t record;  // The press, with the mod-tap keycode.
+  uint16_t tap_keycode;
+  bool interrupted;  // Another key was pressed, `other`.
+  keypos_t other;
+  bool wrong;
+} speculation_t;
+
+static speculation_t held[SPECULATIVE_TAP_MAX_HELD];
+static uint8_t num_held = 0;
+
+// Whether the last key pressed was a letter, and when.
+static bool streak = false;
+static uint16_t last_press_time = 0;
+
+static uint32_t speculated = 0;
+static uint32_t wrong = 0;
+
+__attribute__((weak)) bool speculative_tap_letter(uint16_t keycode) {
+  return KC_A <= keycode && keycode <= KC_Z;
+}
+
+__attribute__((weak)) bool speculative_tap_key(uint16_t keycode) {
+  return true;
+}
+
+static bool same_key(keypos_t a, keypos_t b) {
+  return a.row == b.row && a.col == b.col;
+}
+
+static void mark_wrong(speculation_t* speculation) {
+  if (!speculation->wrong) {
+    speculation->wrong = true;
+    ++wrong;
+    TRACE(SPECULATIVE_TAP_WRONG, 0, speculation->record.keycode, 0);
+  }
+}
+
+static bool release(keyrecord_t* record) {
+  const keypos_t key = record->event.key;
+  // Releasing a key pressed during a held key makes that a permissive hold.
+  for (uint8_t i = 0; i < num_held; ++i) {
+    speculation_t* speculation = &held[i];
+    if (speculation->interrupted && same_key(speculation->other, key) &&
+        get_permissive_hold(speculation->record.keycode,
+                            &speculation->record)) {
+      mark_wrong(speculation);
+    }
+  }
+
+  for (uint8_t i = 0; i < num_held; ++i) {
+    speculation_t* speculation = &held[i];
+    if (!same_key(speculation->record.event.key, key)) {
+      continue;
+    }
+    const uint16_t duration = record->event.time - speculation->record.event.time;
+    if (duration >= get_tapping_term(speculation->record.keycode,
+                                     &speculation->record)) {
+      mark_wrong(speculation);
+    }
+    record->keycode = speculation->tap_keycode;
+    held[i] = held[--num_held];
+    return true;
+  }
+  return false;
+}
+
+bool speculative_tap_pre_process(uint16_t keycode, keyrecord_t* record) {
+  if (record->event.type != KEY_EVENT) {
+    return false;
+  }
+  if (!record->event.pressed) {
+    return release(record);
+  }
+
+  // Every held speculated key is interrupted by this press.
+  for (uint8_t i = 0; i < num_held; ++i) {
+    speculation_t* speculation = &held[i];
+    if (!speculation->interrupted) {
+      speculation->interrupted = true;
+      speculation->other = record->event.key;
+      if (get_hold_on_other_key_press(speculation->record.keycode,
+                                      &speculation->record)) {
+        mark_wrong(speculation);
+      }
+    }
+  }
+
+  const uint16_t time = record->event.time;
+  const bool in_streak =
+      streak && (uint16_t)(time - last_press_time) < SPECULATIVE_TAP_STREAK;
+  const bool mod_tap = IS_QK_MOD_TAP(keycode);
+  const uint16_t tap_keycode =
+      mod_tap ? QK_MOD_TAP_GET_TAP_KEYCODE(keycode) : keycode;
+  streak = speculative_tap_letter(tap_keycode);
+  last_press_time = time;
+
+  if (!mod_tap || !in_streak || !streak || !speculative_tap_key(keycode) ||
+      (get_mods() & ~MOD_MASK_SHIFT) ||
+      num_held == SPECULATIVE_TAP_MAX_HELD) {
+    return false;
+  }
+  speculation_t* speculation = &held[num_held++];
+  *speculation = (speculation_t){.record = *record, .tap_keycode = tap_keycode};
+  speculation->record.keycode = keycode;
+  ++speculated;
+  record->keycode = tap_keycode;
+  return true;
+}
+
+void speculative_tap_print(void) {
+  uprintf("speculative taps %lu, wrong %lu (%lu%%)\n",
+          (unsigned long)speculated, (unsigned long)wrong,
+          (unsigned long)(speculated ? wrong * 100 / speculated : 0));
+}
+
+void speculative_tap_reset(void) {
+  speculated = 0;
+  wrong = 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file speculative_tap.h
+ * @brief Speculative tap: mod-taps typed in a streak are taps right away.
+ *
+ * A mod-tap's letter only goes out once the key is released or the tap/hold
+ * decision is made otherwise, which lags behind fast typing. While typing,
+ * a home row mod is nearly always meant as a letter, so when the previous
+ * key pressed was a letter less than `SPECULATIVE_TAP_STREAK` ms ago, the
+ * mod-tap is resolved to its tap key on press, without waiting. Not while a
+ * modifier other than Shift is held, so shortcuts chain as before.
+ *
+ * Speculated keys are checked against the decision tapping would have made,
+ * with the keymap's `get_hold_on_other_key_press()`, `get_permissive_hold()`
+ * and `get_tapping_term()`, and counted as wrong when it would have been a
+ * hold. `speculative_tap_print()` prints the counts.
+ *
+ * Call `speculative_tap_pre_process()` first thing in
+ * `pre_process_record_user()`, and let the record through without further
+ * pre-processing when it returns true. Speculated keys aren't seen by combos.
+ * Letters are KC_A to KC_Z, keymaps with more letters define
+ * `speculative_tap_letter()`, and keymaps that leave some mod-taps out define
+ * `speculative_tap_key()`.
+ *
+ * Enable with `SPECULATIVE_TAP_ENABLE = yes` in rules.mk. Needs
+ * `REPEAT_KEY_ENABLE` or `COMBO_ENABLE`, which give records the keycode
+ * field that overrides the keymap.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Longest gap in ms between two presses of a typing streak.
+#ifndef SPECULATIVE_TAP_STREAK
+#define SPECULATIVE_TAP_STREAK 125
+#endif  // SPECULATIVE_TAP_STREAK
+
+// Speculated keys that can be held at the same time.
+#ifndef SPECULATIVE_TAP_MAX_HELD
+#define SPECULATIVE_TAP_MAX_HELD 4
+#endif  // SPECULATIVE_TAP_MAX_HELD
+
+/**
+ * Optional callback, whether `keycode` (a basic keycode) types a letter. The
+ * default is true for KC_A to KC_Z.
+ */
+bool speculative_tap_letter(uint16_t keycode);
+
+/**
+ * Optional callback, whether the mod-tap `keycode` is speculated in a streak.
+ * The default is true.
+ */
+bool speculative_tap_key(uint16_t keycode);
+
+#ifdef SPECULATIVE_TAP_ENABLE
+
+/**
+ * Resolves a mod-tap typed in a streak to its tap key. Call from
+ * `pre_process_record_user()`. Returns true if `record` now carries the tap
+ * keycode, for the press and the release of a speculated key.
+ */
+bool speculative_tap_pre_process(uint16_t keycode, keyrecord_t* record);
+
+/** Prints how many mod-taps were speculated and how many were wrong. */
+void speculative_tap_print(void);
+
+/** Clears the counts. */
+void speculative_tap_reset(void);
+
+#else
+
+static inline bool speculative_tap_pre_process(uint16_t keycode,
+                                               keyrecord_t* record) {
+  return false;
+}
+static inline void speculative_tap_print(void) {}
+static inline void speculative_tap_reset(void) {}
+
+#endif  // SPECULATIVE_TAP_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,52 @@
+/**
+ * @file tap_hold_table.c
+ * @brief Tap-hold table implementation
+ */
+
+#include "tap_hold_table.h"
+
+// Keycodes of the table in ascending order, and their entries.
+static uint16_t keycodes[TAP_HOLD_MAX];
+static uint8_t entries[TAP_HOLD_MAX];
+static uint8_t num_keys = 0;
+
+// The entry last looked up, a copy of the defaults with the keycode if the
+// key isn't in the table.
+static tap_hold_t last = TAP_HOLD(KC_NO, TAPPING_TERM, TAP_HOLD_DEFAULT_FLAGS);
+
+void tap_hold_init(void) {
+  num_keys = 0;
+  for (uint8_t i = 0; i < tap_hold_keys_count && i < TAP_HOLD_MAX; ++i) {
+    const uint16_t keycode = pgm_read_word(&tap_hold_keys[i].keycode);
+    uint8_t j = num_keys++;
+    for (; j > 0 && keycodes[j - 1] > keycode; --j) {
+      keycodes[j] = keycodes[j - 1];
+      entries[j] = entries[j - 1];
+    }
+    keycodes[j] = keycode;
+    entries[j] = i;
+  }
+  last = (tap_hold_t)TAP_HOLD(KC_NO, TAPPING_TERM, TAP_HOLD_DEFAULT_FLAGS);
+}
+
+const tap_hold_t* tap_hold_get(uint16_t keycode) {
+  if (keycode == last.keycode) {
+    return &last;
+  }
+  uint8_t low = 0;
+  uint8_t high = num_keys;
+  while (low < high) {
+    const uint8_t mid = (low + high) / 2;
+    if (keycodes[mid] < keycode) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low < num_keys && keycodes[low] == keycode) {
+    memcpy_P(&last, &tap_hold_keys[entries[low]], sizeof(last));
+  } else {
+    last = (tap_hold_t)TAP_HOLD(keycode, TAPPING_TERM, TAP_HOLD_DEFAULT_FLAGS);
+  }
+  return &last;
+}
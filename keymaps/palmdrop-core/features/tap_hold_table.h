@@ -0,0 +1,98 @@
+/**
+ * @file tap_hold_table.h
+ * @brief Tap-hold table: per-key tap-hold settings in one table.
+ *
+ * The per-key callbacks of tap-hold keys each used to switch on the keycode
+ * by themselves, so a key's settings were spread over several functions and
+ * each callback on the tap/hold decision path matched it again. Here every
+ * key that differs from the defaults is one entry of a table in flash:
+ *
+ *     const tap_hold_t PROGMEM tap_hold_keys[] = {
+ *       TAP_HOLD(HR_S, TAPPING_TERM + 50, TAP_HOLD_PERMISSIVE | TAP_HOLD_FLOW),
+ *       TAP_HOLD(LOWER, TAPPING_TERM, TAP_HOLD_ON_OTHER_KEY),
+ *       ...
+ *     };
+ *     const uint8_t tap_hold_keys_count = sizeof(tap_hold_keys) / sizeof(tap_hold_keys[0]);
+ *     _Static_assert(sizeof(tap_hold_keys) / sizeof(tap_hold_keys[0]) <= TAP_HOLD_MAX,
+ *                    "tap_hold_keys: more keys than TAP_HOLD_MAX");
+ *
+ * in any order, with the flags:
+ *
+ *   - `TAP_HOLD_PERMISSIVE` for `get_permissive_hold()`,
+ *   - `TAP_HOLD_ON_OTHER_KEY` for `get_hold_on_other_key_press()`,
+ *   - `TAP_HOLD_FLOW` for mod-taps typed as their tap in a typing streak,
+ *     see features/speculative_tap.h,
+ *   - `TAP_HOLD_ADAPTIVE(slot)` for keys whose term is learned, see
+ *     features/adaptive_tapping.h.
+ *
+ * `TAP_HOLD_QUICK()` also gives the key a quick tap term other than
+ * `QUICK_TAP_TERM`. Keys not in the table get `TAPPING_TERM`,
+ * `QUICK_TAP_TERM` and `TAP_HOLD_DEFAULT_FLAGS`.
+ *
+ * `tap_hold_init()` sorts the keycodes into RAM, `TAP_HOLD_MAX` of them, so
+ * the assert keeps later entries from being left out. `tap_hold_get()` finds a
+ * key's entry by binary search. The entry last looked up is kept, so the
+ * callbacks asked about the same key one after the other share one search:
+ *
+ *     bool get_permissive_hold(uint16_t keycode, keyrecord_t* record) {
+ *       return tap_hold_get(keycode)->flags & TAP_HOLD_PERMISSIVE;
+ *     }
+ *
+ * Call `tap_hold_init()` from `keyboard_post_init_user()`, before anything
+ * that asks for tapping terms.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Most keys in the table.
+#ifndef TAP_HOLD_MAX
+#define TAP_HOLD_MAX 16
+#endif  // TAP_HOLD_MAX
+
+#ifndef QUICK_TAP_TERM
+#define QUICK_TAP_TERM TAPPING_TERM
+#endif  // QUICK_TAP_TERM
+
+#define TAP_HOLD_PERMISSIVE 0x01
+#define TAP_HOLD_ON_OTHER_KEY 0x02
+#define TAP_HOLD_FLOW 0x04
+#define TAP_HOLD_ADAPTIVE(slot) (0x08 | ((slot) << 4))
+
+#define TAP_HOLD_IS_ADAPTIVE(flags) ((flags) & 0x08)
+#define TAP_HOLD_SLOT(flags) ((flags) >> 4)
+
+// Flags of keys not in the table.
+#ifndef TAP_HOLD_DEFAULT_FLAGS
+#define TAP_HOLD_DEFAULT_FLAGS (TAP_HOLD_PERMISSIVE | TAP_HOLD_FLOW)
+#endif  // TAP_HOLD_DEFAULT_FLAGS
+
+typedef struct {
+  uint16_t keycode;
+  uint16_t tapping_term;
+  uint16_t quick_tap_term;
+  uint8_t flags;
+} tap_hold_t;
+
+#define TAP_HOLD(kc, term, flags) TAP_HOLD_QUICK(kc, term, QUICK_TAP_TERM, flags)
+#define TAP_HOLD_QUICK(kc, term, quick_tap_term, flags) \
+  { (kc), (term), (quick_tap_term), (flags) }
+
+/** Keys with their own settings, in any order. Define in keymap.c. */
+extern const tap_hold_t tap_hold_keys[];
+extern const uint8_t tap_hold_keys_count;
+
+/** Sorts the keycodes of the table. */
+void tap_hold_init(void);
+
+/** Settings of `keycode`, valid until the next call. */
+const tap_hold_t* tap_hold_get(uint16_t keycode);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file trace_buffer.c
+ * @brief Trace buffer implementation
+ */
+
+#include "trace_buffer.h"
+
+#if (TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1)) != 0 || \
+    TRACE_BUFFER_SIZE > 128
+#error "trace_buffer: TRACE_BUFFER_SIZE must be a power of two, at most 128"
+#endif
+
+typedef struct {
+  uint8_t event;
+  uint8_t a;
+  uint16_t time;
+  uint16_t b;
+  uint16_t c;
+} trace_record_t;
+
+static trace_record_t ring[TRACE_BUFFER_SIZE];
+// Free-running indices: `head` is only written by the producer and `tail` only
+// by the consumer. Their difference is the number of pending records, which
+// needs a bit more than the ring's size to tell a full ring from an empty one.
+static volatile uint8_t head = 0;
+static volatile uint8_t tail = 0;
+static uint16_t dropped = 0;
+
+void trace_buffer_write(uint8_t event, uint8_t a, uint16_t b, uint16_t c) {
+  const uint8_t index = head;
+  if ((uint8_t)(index - tail) >= TRACE_BUFFER_SIZE) {
+    ++dropped;
+    return;
+  }
+  trace_record_t* record = &ring[index & (TRACE_BUFFER_SIZE - 1)];
+  record->event = event;
+  record->a = a;
+  record->time = timer_read();
+  record->b = b;
+  record->c = c;
+  head = index + 1;  // Publish only once the record is complete.
+}
+
+static void send_hex(uint16_t value, uint8_t digits) {
+  while (digits--) {
+    const uint8_t nibble = (value >> (4 * digits)) & 0xF;
+    sendchar(nibble < 10 ? '0' + nibble : 'A' - 10 + nibble);
+  }
+}
+
+void trace_buffer_task(void) {
+  if (dropped && (uint8_t)(head - tail) < TRACE_BUFFER_SIZE) {
+    const uint16_t count = dropped;
+    dropped = 0;
+    trace_buffer_write(TRACE_DROPPED, 0, count, 0);
+  }
+
+  for (uint8_t i = 0; i < TRACE_BUFFER_DRAIN_PER_TASK && tail != head; ++i) {
+    const trace_record_t* record = &ring[tail & (TRACE_BUFFER_SIZE - 1)];
+    sendchar('~');
+    send_hex(record->event, 2);
+    send_hex(record->a, 2);
+    send_hex(record->time, 4);
+    send_hex(record->b, 4);
+    send_hex(record->c, 4);
+    sendchar('\n');
+    tail = tail + 1;
+  }
+}
@@ -0,0 +1,76 @@
+/**
+ * @file trace_buffer.h
+ * @brief Trace buffer: deferred, tokenized debug tracing.
+ *
+ * Formatting debug text with `dprintf()` on every key press costs time on the
+ * hot path and flash for every format string. Instead, hot path sites call
+ *
+ *     TRACE(SENTENCE_CASE_STATE, new_state, 0, 0);
+ *
+ * which writes a fixed-size binary record (event id, timestamp and three
+ * arguments) into a RAM ring buffer. `trace_buffer_task()`, called from
+ * `housekeeping_task_user()`, drains a few records per main loop iteration
+ * to the console as hex lines of the form `~IIAATTTTBBBBCCCC`, and
+ * `scripts/trace_decode.py` turns them back into readable logs on the host:
+ *
+ *     qmk console | python3 scripts/trace_decode.py
+ *
+ * Events are declared in `trace_events.h`, together with the format strings
+ * that only the decoder uses.
+ *
+ * The ring has a single producer (the key processing code) and a single
+ * consumer (the drain), each owning one index, so no locking is needed. When
+ * the buffer is full, new records are dropped and counted, and a DROPPED
+ * record is emitted once there is room again.
+ *
+ * Enable with `TRACE_BUFFER_ENABLE = yes` in rules.mk. When disabled, `TRACE`
+ * compiles to nothing.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of records in the ring, a power of two up to 128.
+#ifndef TRACE_BUFFER_SIZE
+#define TRACE_BUFFER_SIZE 64
+#endif  // TRACE_BUFFER_SIZE
+
+// Maximum number of records drained per call to `trace_buffer_task()`.
+#ifndef TRACE_BUFFER_DRAIN_PER_TASK
+#define TRACE_BUFFER_DRAIN_PER_TASK 2
+#endif  // TRACE_BUFFER_DRAIN_PER_TASK
+
+/** Trace event ids, generated from trace_events.h. */
+enum trace_event {
+#define TRACE_EVENT(name, format) TRACE_##name,
+#include "trace_events.h"
+#undef TRACE_EVENT
+  TRACE_NUM_EVENTS
+};
+
+#ifdef TRACE_BUFFER_ENABLE
+
+/** Records `event` with arguments `a` (8-bit), `b` and `c` (16-bit). */
+void trace_buffer_write(uint8_t event, uint8_t a, uint16_t b, uint16_t c);
+
+/** Drains pending records to the console. Call from housekeeping. */
+void trace_buffer_task(void);
+
+#define TRACE(event, a, b, c) trace_buffer_write(TRACE_##event, (a), (b), (c))
+
+#else
+
+static inline void trace_buffer_task(void) {}
+
+#define TRACE(event, a, b, c) ((void)0)
+
+#endif  // TRACE_BUFFER_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
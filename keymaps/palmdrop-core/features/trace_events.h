@@ -0,0 +1,25 @@
+/**
+ * @file trace_events.h
+ * @brief Event table for the binary trace buffer.
+ *
+ * X-macro list of `TRACE_EVENT(name, format)`. The firmware only uses the
+ * names, which become `TRACE_<name>` ids in order of appearance. The format
+ * strings stay on the host: `scripts/trace_decode.py` reads them from this
+ * file to rebuild readable logs. They use Python `str.format()` syntax with
+ * the arguments `a` (8-bit), `b` and `c` (16-bit), `c_hi`/`c_lo` for the
+ * bytes of `c`, plus `{a|X,Y,Z}` to print the a'th name of a list.
+ *
+ * Only append to the list, so that old captures still decode.
+ */
+
+// clang-format off
+TRACE_EVENT(DROPPED,               "dropped {b} events (buffer full)")
+TRACE_EVENT(KEY,                   "key {b:04X} row {c_hi} col {c_lo} {a|up,down}")
+TRACE_EVENT(SENTENCE_CASE_STATE,   "Sentence case: {a|INIT,WORD,ABBREV,ENDING,PRIMED,DISABLED}")
+TRACE_EVENT(SENTENCE_CASE_CODE,    "Sentence Case: code = '{a:c}' ({a}) for {b:04X}")
+TRACE_EVENT(SENTENCE_CASE_NOT_END, "Not a real ending.")
+TRACE_EVENT(LEADER,                "Leader: action {a}, typed {b} keys")
+TRACE_EVENT(COMBO,                 "Combo: {a} (0 for none) after {c} ms, {b} events held back")
+TRACE_EVENT(TAPPING_TERM,          "Tapping term: slot {a} from {c} to {b} ms")
+TRACE_EVENT(SPECULATIVE_TAP_WRONG, "Speculative tap: {b:04X} would have been a hold")
+// clang-format on
@@ -21,6 +21,24 @@
 #include "sendstring_swedish.h"
 #include "features/layer_lock.h"
 #include "features/sentence_case.h"
+#include "features/scheduler.h"
+#include "features/pipeline_profile.h"
+#include "features/trace_buffer.h"
+#include "features/eager_debounce.h"
+#include "features/latency_stats.h"
+#include "features/leader_trie.h"
+#include "features/position_combos.h"
+#include "features/adaptive_tapping.h"
+#include "features/speculative_tap.h"
+#include "features/chordal_hold.h"
+#include "features/eager_tap_dance.h"
+#include "features/macro_store.h"
+#include "features/report_coalesce.h"
+#include "features/packed_string.h"
+#include "features/case_mode.h"
+#include "features/tap_hold_table.h"
+#include "features/keycode_cache.h"
+#include "features/feature_chain.h"
 
 #ifdef AUDIO_ENABLE
 #    include "muse.h"
@@ -37,13 +55,7 @@ enum planck_layers {
 
   // Special
   _COMMAND,
-  _ADJUST,
-
-  // Variable input
-  _CAMEL,
-  _SNAKE, // doubles as CONSTANT layer when shift is held
-  // _CONSTANT,
-  _KEBAB
+  _ADJUST
 };
 
 enum planck_keycodes {
@@ -62,14 +74,23 @@ enum custom_keycodes {
   CK_VIM,  // qmk-vim mode feature
 
   CK_WSWI, // switch window
+  CK_RPLY, // replay the last edit, up to escape
+
+  CK_LSTP, // print scan rate and latency stats
+  CK_LSTR, // reset scan rate and latency stats
 
   // Dummy keycodes
   CK_TILD, // ~
   CK_GRV,  // `
   CK_CIRC, // ^
 
-  // Dummy layer
-  CK_CONSTANT
+  // Identifier case modes, in the order of case_mode_t
+  CK_CAMEL, // camelCase
+  CK_PSCL,  // PascalCase
+  CK_SNAK,  // snake_case
+  CK_CNST,  // CONSTANT_CASE
+  CK_KEBB,  // kebab-case
+  CK_DOTC   // dot.case
 };
 
 // Multi-key codes
@@ -110,24 +131,23 @@ enum custom_keycodes {
 #define HR_L RSFT_T(KC_L)
 #define HR_ODIA RCTL_T(SE_ODIA)
 
-// Combos
-const uint16_t PROGMEM meta_combo[]      = {HR_S, HR_D, COMBO_END};
-const uint16_t PROGMEM escape_combo[]    = {HR_F, HR_J, COMBO_END};
-const uint16_t PROGMEM backspace_combo[] = {HR_J, HR_K, COMBO_END};
+// Combos are declared in combos.txt
 
-combo_t key_combos[] = {
-  COMBO(meta_combo, KC_LGUI),
-  COMBO(escape_combo, KC_ESC),
-  COMBO(backspace_combo, KC_BSPC)
-};
+#ifdef LATENCY_STATS_ENABLE
+// Keys held back by the combo term, for the latency stats
+bool latency_stats_combo_key(keypos_t key) {
+  return position_combo_key(key);
+}
+#endif
 
 // Tap dance
 enum tap_dance_codes {
   TD_GG = 0
 };
 
-tap_dance_action_t tap_dance_actions[] = {
-  [TD_GG] = ACTION_TAP_DANCE_DOUBLE(KC_END, KC_HOME)
+// Single taps go out on press, a double tap sends Home after the End
+const eager_tap_dance_t eager_tap_dances[] = {
+  [TD_GG] = EAGER_TAP_DANCE_DOUBLE(KC_END, KC_HOME)
 };
 
 // Empty layer
@@ -211,7 +231,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
   * ,-----------------------------------------------------------------------------------.
   * |      |      |C+Rght|      |S+Undo|      | Copy | Undo | Home |Enter |Paste | Bspc |
   * |------+------+------+------+------+------+------+------+------+------+------+------|
-  * |      | End  |      |Del/S | Ctrl |  GG  | Left | Down |  Up  |Right | WUp  |C+Bspc|
+  * |      | End  |Replay|Del/S | Ctrl |  GG  | Left | Down |  Up  |Right | WUp  |C+Bspc|
   * |------+------+------+------+------+------+------+------+------+------+------+------|
   * |Shift |      | Bspc | Bspc |      |C+Left|MLeft |MDown | MUp  |MRght |WDown |      |
   * |------+------+------+------+------+------+------+------+------+------+------+------|
@@ -220,16 +240,16 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
   */
   [_NAVIGATION] = LAYOUT_planck_grid(
       _______,   _______,  LCTL(KC_RGHT),  _______,         REDO,     _______,        COPY,     UNDO,     KC_HOME,  KC_ENT,           PASTE,           KC_BSPC,
-      TO(_BASE), KC_END,   _______,        LSFT_T(KC_DEL),  KC_LCTL,  TD(TD_GG),      KC_LEFT,  KC_DOWN,  KC_UP,    RSFT_T(KC_RGHT),  KC_WH_U,         RCTL(KC_BSPC),
+      TO(_BASE), KC_END,   CK_RPLY,        LSFT_T(KC_DEL),  KC_LCTL,  TD(TD_GG),      KC_LEFT,  KC_DOWN,  KC_UP,    RSFT_T(KC_RGHT),  KC_WH_U,         RCTL(KC_BSPC),
       KC_LSFT,   _______,  KC_BSPC,        KC_BSPC,         _______,  LCTL(KC_LEFT),  KC_MS_L,  KC_MS_D,  KC_MS_U,  KC_MS_R,          KC_WH_D,         _______,
       _______,   _______,  _______,        CK_LLCK,         CK_VIM,   KC_BTN1,        KC_BTN1,  KC_BTN2,  _______,  _______,          _______,         _______
   ),
 
   /* Command
   * ,-----------------------------------------------------------------------------------.
-  * |      |      |      |      |      |      |      |      |C+S+I |      |S+Ins |C+A+D |
+  * | Play | Rec  |SntCse|PlyDly|      |      |      |      |C+S+I |      |S+Ins |C+A+D |
   * |------+------+------+------+------+------+------+------+------+------+------+------|
-  * | Caps |      |SysRq |      |      |      |      |      |      |      |      |      |
+  * | Caps |      |SysRq |      |      |      |Pascal|camel |snake |kebab |CONST | dot  |
   * |------+------+------+------+------+------+------+------+------+------+------+------|
   * |      |      |      |CpsWrd|      |      |      |      |      |      |      |      |
   * |------+------+------+------+------+------+------+------+------+------+------+------|
@@ -237,10 +257,9 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
   * `-----------------------------------------------------------------------------------'
   */
   [_COMMAND] = LAYOUT_planck_grid(
-                 // NOTE: Could maybe access rec2 by double-tapping?
-                 // NOTE: could also mabye use leader key for creating macros?
-      DM_PLY1,   DM_REC1,  CK_SNTC,  _______,  _______, _______,   _______,  _______,    CTLSFTI,     _______,      LSFT(KC_INS), CTLALTDEL,
-      CK_CAPS,   _______,  KC_SYRQ,  _______,  _______, _______,   _______,  TO(_CAMEL), TO(_SNAKE),  TO(_KEBAB),   CK_CONSTANT,  _______,
+                 // Record and play are followed by a slot key, a to h
+      DM_PLY1,   DM_REC1,  CK_SNTC,  DM_PLY2,  _______, _______,   _______,  _______,    CTLSFTI,     _______,      LSFT(KC_INS), CTLALTDEL,
+      CK_CAPS,   _______,  KC_SYRQ,  _______,  _______, _______,   CK_PSCL,  CK_CAMEL,   CK_SNAK,     CK_KEBB,      CK_CNST,      CK_DOTC,
       _______,   _______,  _______,  CW_TOGG,  _______, _______,   _______,  _______,    _______,     _______,      _______,      _______,
       _______,   _______,  _______,  _______,  _______, _______,   _______,  _______,    _______,     _______,      _______,      _______
   ),
@@ -251,7 +270,7 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
   * |------+------+------+------+------+------+------+------+------+------+------+------|
   * |      |      | Vol- | Vol+ |Mute  |      |      |KBri- |KBri+ |KBTgl |      | Boot |
   * |------+------+------+------+------+------+------+------+------+------+------+------|
-  * |      |      |      |      |      |      |      |      |      |      |      |      |
+  * |      |      |      |      |      |      |      |      |      |LatPrt|LatRst|      |
   * |------+------+------+------+------+------+------+------+------+------+------+------|
   * |      |      |      |      |      |             |      |      |      |      |      |
   * `-----------------------------------------------------------------------------------'
@@ -259,203 +278,156 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
   [_ADJUST] = LAYOUT_planck_grid(
       _______, _______, KC_MPRV, KC_MPLY, KC_MNXT, _______, _______, KC_BRID, KC_BRIU, _______, KC_SYRQ, _______, 
       _______, _______, KC_VOLD, KC_VOLU, KC_MUTE, _______, _______, BL_DOWN, BL_UP,   BL_TOGG, _______, QK_BOOT,
-      _______, _______, _______, _______, _______, _______, _______, _______, _______, _______, _______, _______,
+      _______, _______, _______, _______, _______, _______, _______, _______, _______, CK_LSTP, CK_LSTR, _______,
       _______, _______, _______, _______, _______, _______, _______, _______, _______, _______, _______, _______
-  ),
+  )
+};
 
-  /* camelCase
-  * ,-----------------------------------------------------------------------------------.
-  * |      |      |      |      |      |      |      |      |      |      |      |      |
-  * |------+------+------+------+------+------+------+------+------+------+------+------|
-  * |      |      |      |      |      |      |      |      |      |      |      |      |
-  * |------+------+------+------+------+------+------+------+------+------+------+------|
-  * |      |      |      |      |      |      |      |      |      |      |      |      |
-  * |------+------+------+------+------+------+------+------+------+------+------+------|
-  * |      |      |      |      |      |Oneshot shift|      |      |      |      |      |
-  * `-----------------------------------------------------------------------------------'
-  */
-  [_CAMEL] = LAYOUT_planck_grid(
-      _______,   _______,  _______,  _______,  _______,  _______,        _______,        _______,  _______,  _______,  _______,  _______,
-      TO(_BASE), _______,  _______,  _______,  _______,  _______,        _______,        _______,  _______,  _______,  _______,  _______,
-      _______,   _______,  _______,  _______,  _______,  _______,        _______,        _______,  _______,  _______,  _______,  _______,
-      _______,   _______,  _______,  _______,  _______,  OSM(MOD_LSFT),  OSM(MOD_LSFT),  _______,  _______,  _______,  _______,  _______
-  ),
+// Per key settings
+// Tap-hold keys that differ from TAPPING_TERM and a permissive hold, see features/tap_hold_table.h
+// Adaptive slots are where their learned terms are saved in EEPROM, keep them when adding keys.
+const tap_hold_t PROGMEM tap_hold_keys[] = {
+  // Home row mods, speculated as letters in a streak
+  TAP_HOLD(HR_S,    TAPPING_TERM + 50, TAP_HOLD_PERMISSIVE | TAP_HOLD_FLOW | TAP_HOLD_ADAPTIVE(0)), // NOTE: Not sure if the longer term actually helps
+  TAP_HOLD(HR_D,    TAPPING_TERM,      TAP_HOLD_PERMISSIVE | TAP_HOLD_FLOW | TAP_HOLD_ADAPTIVE(1)),
+  TAP_HOLD(HR_F,    TAPPING_TERM,      TAP_HOLD_PERMISSIVE | TAP_HOLD_FLOW | TAP_HOLD_ADAPTIVE(2)),
+  TAP_HOLD(HR_L,    TAPPING_TERM,      TAP_HOLD_PERMISSIVE | TAP_HOLD_FLOW | TAP_HOLD_ADAPTIVE(3)),
+  TAP_HOLD(HR_ODIA, TAPPING_TERM,      TAP_HOLD_PERMISSIVE | TAP_HOLD_FLOW | TAP_HOLD_ADAPTIVE(4)),
+
+  // Layer keys
+  // Hold is prioritized for LOWER, so it's possible to roll to its layer without accidentally triggering the tap action.
+  // RAISE taps a one-shot shift (see process_keycodes) and is left permissive only, so a quick shift + letter stays a tap.
+  TAP_HOLD(LOWER,   TAPPING_TERM,      TAP_HOLD_PERMISSIVE | TAP_HOLD_ON_OTHER_KEY | TAP_HOLD_ADAPTIVE(5)),
+  TAP_HOLD(RAISE,   TAPPING_TERM,      TAP_HOLD_PERMISSIVE | TAP_HOLD_ADAPTIVE(6)),
+  TAP_HOLD(NAVESQ,  TAPPING_TERM,      TAP_HOLD_PERMISSIVE | TAP_HOLD_ADAPTIVE(7)),
+  TAP_HOLD(NAVSPC,  TAPPING_TERM + 50, TAP_HOLD_PERMISSIVE),
+};
+const uint8_t tap_hold_keys_count = sizeof(tap_hold_keys) / sizeof(tap_hold_keys[0]);
+_Static_assert(sizeof(tap_hold_keys) / sizeof(tap_hold_keys[0]) <= TAP_HOLD_MAX, "tap_hold_keys: more keys than TAP_HOLD_MAX");
 
-  /* snake_case
-  * ,-----------------------------------------------------------------------------------.
-  * |      |      |      |      |      |      |      |      |      |      |      |      |
-  * |------+------+------+------+------+------+------+------+------+------+------+------|
-  * |      |      |      |      |      |      |      |      |      |      |      |      |
-  * |------+------+------+------+------+------+------+------+------+------+------+------|
-  * |      |      |      |      |      |      |      |      |      |      |      |      |
-  * |------+------+------+------+------+------+------+------+------+------+------+------|
-  * |      |      |      |      |      |  underscore |      |      |      |      |      |
-  * `-----------------------------------------------------------------------------------'
-  */
-  [_SNAKE] = LAYOUT_planck_grid(
-      _______,   _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,
-      TO(_BASE), _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,
-      _______,   _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,
-      _______,   _______,  _______,  _______,  _______,  SE_UNDS,  SE_UNDS,  _______,  _______,  _______,  _______,  _______
-  ),
+// The callbacks below are asked about the same key in a row, and share one lookup of it.
 
-  /* kebab-case
-  * ,-----------------------------------------------------------------------------------.
-  * |      |      |      |      |      |      |      |      |      |      |      |      |
-  * |------+------+------+------+------+------+------+------+------+------+------+------|
-  * |      |      |      |      |      |      |      |      |      |      |      |      |
-  * |------+------+------+------+------+------+------+------+------+------+------+------|
-  * |      |      |      |      |      |      |      |      |      |      |      |      |
-  * |------+------+------+------+------+------+------+------+------+------+------+------|
-  * |      |      |      |      |      |    minus    |      |      |      |      |      |
-  * `-----------------------------------------------------------------------------------'
-  */
-  [_KEBAB] = LAYOUT_planck_grid(
-      _______,   _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,
-      TO(_BASE), _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,
-      _______,   _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,  _______,
-      _______,   _______,  _______,  _______,  _______,  SE_MINS,  SE_MINS,  _______,  _______,  _______,  _______,  _______
-  ),
-};
+// Keys whose tapping terms are learned from how they're typed, see features/adaptive_tapping.h
+uint8_t adaptive_tapping_slot(uint16_t keycode) {
+  const uint8_t flags = tap_hold_get(keycode)->flags;
+  return TAP_HOLD_IS_ADAPTIVE(flags) ? TAP_HOLD_SLOT(flags) : ADAPTIVE_TAPPING_NONE;
+}
 
-// Per key settings
 uint16_t get_tapping_term(uint16_t keycode, keyrecord_t *record) {
-  switch (keycode) {
-    case NAVSPC: 
-    case HR_S: // NOTE: Not sure if this actually helps
-      return TAPPING_TERM + 50;
-    default:
-      return TAPPING_TERM;
-  }
-};
+  // The table's term is the starting point until a key has a learned term
+  return adaptive_tapping_term(keycode, tap_hold_get(keycode)->tapping_term);
+}
+
+uint16_t get_quick_tap_term(uint16_t keycode, keyrecord_t *record) {
+  return tap_hold_get(keycode)->quick_tap_term;
+}
 
 bool get_hold_on_other_key_press(uint16_t keycode, keyrecord_t *record) {
-  switch (keycode) {
-    // Ensure that hold action is prioritized for layer keys
-    // This ensures that it's possible to roll to these layers without accidentally triggering the tap action.
-    // case RAISE:
-    case LOWER:
-      return true;
-    default:
-      return false;
-  }
+  return tap_hold_get(keycode)->flags & TAP_HOLD_ON_OTHER_KEY;
 }
 
+// Same-hand rolls are settled as taps by chordal hold before this applies
 bool get_permissive_hold(uint16_t keycode, keyrecord_t *record) {
-  switch (keycode) {
-    case HR_S: // NOTE: Not sure if this actually helps
-      return false;
-    default:
-      return true;
+  return tap_hold_get(keycode)->flags & TAP_HOLD_PERMISSIVE;
+}
+
+bool speculative_tap_key(uint16_t keycode) {
+  return tap_hold_get(keycode)->flags & TAP_HOLD_FLOW;
+}
+
+#ifdef CHORDAL_HOLD_ENABLE
+// Hand of each key for chordal hold, '*' keys go with either hand
+const char chordal_hold_layout[MATRIX_ROWS][MATRIX_COLS] PROGMEM = LAYOUT_planck_grid(
+  'L', 'L', 'L', 'L', 'L', 'L', 'R', 'R', 'R', 'R', 'R', 'R',
+  'L', 'L', 'L', 'L', 'L', 'L', 'R', 'R', 'R', 'R', 'R', 'R',
+  'L', 'L', 'L', 'L', 'L', 'L', 'R', 'R', 'R', 'R', 'R', 'R',
+  'L', 'L', 'L', '*', '*', '*', '*', '*', '*', 'R', 'R', 'R'
+);
+
+bool get_chordal_hold(uint16_t tap_hold_keycode, keyrecord_t *tap_hold_record,
+                      uint16_t other_keycode, keyrecord_t *other_record) {
+  // Same-hand combos like S + D are left for combos to match
+  if (position_combo_pair(tap_hold_record->event.key, other_record->event.key)) {
+    return true;
   }
+  return get_chordal_hold_default(tap_hold_record, other_record);
 }
+#endif  // CHORDAL_HOLD_ENABLE
 
 // Backlight
-// #define RGB_BASE {0x17, 0x37, 0x17}
-// #define RGB_LBASE {0x03, 0x07, 0x03}
-#define RGB_BASE {0x07, 0x00, 0x00}
-#define RGB_LBASE {0x01, 0x00, 0x00}
+// Layer colors are generated from ledmap.txt and the keymaps above by scripts/gen_ledmap.py
+#include "ledmap.h"
 
-#define RGB_SYS {0xFF, 0xFF, 0x00}
-#define RGB_WARN {0xFF, 0x00, 0x00}
+#ifndef RGB_MATRIX_CUSTOM_USER
+#error "ledmap: the layer colors are an effect from rgb_matrix_user.inc, set RGB_MATRIX_CUSTOM_USER = yes"
+#endif
 
-/*
-[_LAYER] = {
-  RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP,
-  RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP,
-  RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP,
-  RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP, RGB_TMP
-},
-*/
+// Row of ledmap to show for a layer, layers without colors of their own show the first row
+static uint8_t ledmap_row(uint8_t layer) {
+  return layer < sizeof(ledmap_rows) ? pgm_read_byte(&ledmap_rows[layer]) : 0;
+}
 
-const uint8_t PROGMEM ledmap[][RGB_MATRIX_LED_COUNT][3] = {
-  [_BASE] = {
-    RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE,
-    RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE,
-    RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE,
-    RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE,      RGB_LBASE,     RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE
-  },
-
-  [_ADJUST] = {
-    RGB_BASE, RGB_BASE, RGB_SYS,  RGB_SYS,  RGB_SYS,  RGB_BASE, RGB_BASE, RGB_SYS,  RGB_SYS,  RGB_BASE, RGB_SYS,  RGB_BASE,
-    RGB_BASE, RGB_BASE, RGB_SYS,  RGB_SYS,  RGB_SYS,  RGB_BASE, RGB_BASE, RGB_SYS,  RGB_SYS,  RGB_SYS,  RGB_BASE, RGB_WARN,
-    RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE,
-    RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE,      RGB_LBASE,     RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE
-  },
-  /*
-  [_BASE] = {
-    RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE,
-    RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE,
-    RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE,
-    RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE,      RGB_LBASE,     RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE, RGB_BASE
-  },
-
-  [_LOWER] = {
-    RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER,
-    RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER,
-    RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER,
-    RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER,      RGB_LLOWER,      RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER, RGB_LOWER
-  },
-
-  [_RAISE] = {
-    RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE,
-    RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE,
-    RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE,
-    RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE,       RGB_LRAISE,     RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE, RGB_RAISE
-  },
-
-  [_NAVIGATION] = {
-    RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV,
-    RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV,
-    RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV,
-    RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV,      RGB_LNAV,    RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV, RGB_NAV
-  },
-
-  [_COMMAND] = {
-    RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD,
-    RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD,
-    RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD,
-    RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD,      RGB_LCMD,    RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD, RGB_CMD
-  },
-
-  [_ADJUST] = {
-    RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST,
-    RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST,
-    RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST,
-    RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST,       RGB_LADJST,     RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST, RGB_ADJST
-  }
-  */
-};
+// Layer colors are shown by the LEDMAP effect (rgb_matrix_user.inc), which
+// paints nothing of its own, so LEDs keep their colors between frames. The
+// colors are rendered into led_cache only when the state they are rendered
+// for changes, and only LEDs that differ from what was last pushed are written
+// to the driver. Frames that write nothing are counted as skipped.
+static RGB led_cache[RGB_MATRIX_LED_COUNT];
+static RGB led_pushed[RGB_MATRIX_LED_COUNT];
+static uint16_t led_cache_state = UINT16_MAX; // Nothing rendered yet
+static bool led_frame_pushed = false;
+static uint32_t led_frames = 0;
+static uint32_t led_frames_skipped = 0;
+
+// Everything the LED colors are rendered for: the ledmap row, and whether the
+// layer is locked, caps word is on and vim mode is on.
+static uint16_t led_state(void) {
+  const uint8_t layer = get_highest_layer(layer_state);
+  return ledmap_row(layer) | is_layer_locked(layer) << 8 | is_caps_word_on() << 9 | vim_mode_enabled() << 10;
+}
 
-void set_layer_color(int layer) {
+void set_layer_color(int row) {
   for (int i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
-    RGB rgb = {
-      .r = pgm_read_byte(&ledmap[layer][i][0]),
-      .g = pgm_read_byte(&ledmap[layer][i][1]),
-      .b = pgm_read_byte(&ledmap[layer][i][2]),
+    const uint8_t color = pgm_read_byte(&ledmap[row][i]);
+    led_cache[i] = (RGB){
+      .r = pgm_read_byte(&ledmap_palette[color][0]),
+      .g = pgm_read_byte(&ledmap_palette[color][1]),
+      .b = pgm_read_byte(&ledmap_palette[color][2]),
     };
-    rgb_matrix_set_color( i, rgb.r, rgb.g, rgb.b );
   }
 }
 
-bool rgb_matrix_indicators_user(void) {
-  /*
-  if (g_suspend_state || disable_layer_color) { 
-    return false; 
+// The LEDMAP effect, run on each frame for the LEDs in its limits
+bool ledmap_render(effect_params_t* params) {
+  RGB_MATRIX_USE_LIMITS(led_min, led_max);
+
+  if (led_min == 0) {
+    ++led_frames;
+    led_frame_pushed = false;
+    const uint16_t state = led_state();
+    if (state != led_cache_state) {
+      led_cache_state = state;
+      set_layer_color(state & 0xFF);
+    }
   }
-  */
 
-  switch (get_highest_layer(layer_state)) {
-    case _ADJUST: 
-      set_layer_color(_ADJUST);
-      break;
-    case _BASE: 
-    default:
-      set_layer_color(_BASE);
-      break;
+  // On init another effect may have painted over the LEDs, push them all
+  for (uint8_t i = led_min; i < led_max; i++) {
+    if (params->init || memcmp(&led_cache[i], &led_pushed[i], sizeof(RGB)) != 0) {
+      rgb_matrix_set_color( i, led_cache[i].r, led_cache[i].g, led_cache[i].b );
+      led_pushed[i] = led_cache[i];
+      led_frame_pushed = true;
+    }
   }
 
-  return false;
+  if (led_max == RGB_MATRIX_LED_COUNT && !led_frame_pushed) {
+    ++led_frames_skipped;
+  }
+  return rgb_matrix_check_finished_leds(led_max);
+}
+
+void led_cache_print(void) {
+  uprintf("led frames %lu skipped %lu\n", (unsigned long)led_frames, (unsigned long)led_frames_skipped);
 }
 
 // Misc
@@ -466,11 +438,10 @@ bool rgb_matrix_indicators_user(void) {
 #endif
 */
 
-/*
 layer_state_t layer_state_set_user(layer_state_t state) {
-  return update_tri_layer_state(state, _LOWER, _RAISE, _COMMAND);
+  // return update_tri_layer_state(state, _LOWER, _RAISE, _COMMAND);
+  return keycode_cache_layer_state_set(state);
 }
-*/
 
 
 // Caps management
@@ -516,41 +487,120 @@ bool caps_word_press_user(uint16_t keycode) {
 
 bool is_sentence_case_enabled = false;
 
-bool process_record_user(uint16_t keycode, keyrecord_t *record) {
-  // Process vim modes
-  if (!process_vim_mode(keycode, record)) {
-    return false;
-  }
+static bool process_keycodes(uint16_t keycode, keyrecord_t *record);
 
-  // Custom code for stop recording dynamic macros using escape
-  // https://github.com/qmk/qmk_firmware/blob/master/docs/feature_dynamic_macros.md#dynamic_macro_user_call
-	uint16_t macro_kc = ((keycode == NAVESQ) ? DM_RSTP : keycode);
-	if (!process_dynamic_macro(macro_kc, record)) {
+// Macros, and replaying what was typed since the second to last escape
+static bool process_macros(uint16_t keycode, keyrecord_t *record) {
+  if (!process_macro_store(keycode, record, CK_RPLY)) {
     disable_caps();
-		return false;
-	}
-
-  // layer lock feature
-  // https://getreuer.info/posts/keyboards/layer-lock/index.html
-  if (!process_layer_lock(keycode, record, CK_LLCK)) {
     return false;
   }
+  return true;
+}
 
-  // caps word e
-  if (!process_caps_word(keycode, record)) { 
-    return false; 
+// Taps handled in process_keycodes, replayed as the key rather than the low byte
+// of their custom keycode
+bool macro_store_custom_tap(uint16_t keycode) {
+  switch (keycode) {
+    case RAISE:
+    case SFTCW:
+    case ALTSWI:
+      return true;
   }
+  return false;
+}
+
+// layer lock feature
+// https://getreuer.info/posts/keyboards/layer-lock/index.html
+static bool process_lock(uint16_t keycode, keyrecord_t *record) {
+  return process_layer_lock(keycode, record, CK_LLCK);
+}
+
+// sentence case feature, disabled if caps is enabled
+static bool sentence_case_active(void) {
+  return is_sentence_case_enabled && !is_caps_enabled;
+}
+
+// The leader sees every key during a sequence, and releases after it of the
+// keys it consumed.
+static bool leader_busy(void) {
+  return leader_trie_active() || leader_trie_holding();
+}
+
+static bool case_mode_active(void) {
+  return case_mode_get() != CASE_MODE_OFF;
+}
+
+// Features of process_record_user in the order they run, with the keycode classes
+// each one needs to see, see features/feature_chain.h. Most only see every key while
+// they're on, and only their own keys otherwise.
+const feature_t PROGMEM features[] = {
+  // Leader sequences, before anything else sees the keys typed in them
+  FEATURE("leader", process_leader_trie, KEYCODE_CLASSES(QUANTUM), leader_busy, KEYCODE_CLASSES_ALL),
+  // Process vim modes, toggled by CK_VIM below
+  FEATURE("vim", process_vim_mode, KEYCODE_CLASSES_NONE, vim_mode_enabled, KEYCODE_CLASSES_ALL),
+  // Records everything typed for replay
+  FEATURE_ALWAYS("macro store", process_macros, KEYCODE_CLASSES_ALL),
+  FEATURE("layer lock", process_lock, KEYCODE_CLASSES(USER), layer_lock_active, KEYCODE_CLASSES_ALL),
+  // Tap dances send their single tap on press, and end on any other key
+  FEATURE("tap dance", process_eager_tap_dance, KEYCODE_CLASSES(QUANTUM), eager_tap_dance_active, KEYCODE_CLASSES_ALL),
+  FEATURE("caps word", process_caps_word, KEYCODE_CLASSES(QUANTUM), is_caps_word_on, KEYCODE_CLASSES_ALL),
+  // Identifiers typed as words, see features/case_mode.h
+  FEATURE("case mode", process_case_mode, KEYCODE_CLASSES_NONE, case_mode_active, KEYCODE_CLASSES_ALL),
+  FEATURE("sentence case", process_sentence_case, KEYCODE_CLASSES_NONE, sentence_case_active, KEYCODE_CLASSES_ALL),
+  // The switch below only has tap-hold, layer and custom keys
+  FEATURE_ALWAYS("keycodes", process_keycodes,
+    KEYCODE_CLASSES(MOD_TAP) | KEYCODE_CLASSES(LAYER_TAP) | KEYCODE_CLASSES(LAYER) | KEYCODE_CLASSES(USER)),
+};
+const uint8_t features_count = sizeof(features) / sizeof(features[0]);
+
+#ifdef PIPELINE_PROFILE_ENABLE
+const char* pipeline_profile_stage_name(uint8_t stage) {
+  return feature_chain_name(stage);
+}
+#endif
 
-  // sentence case feature
-  if (
-    is_sentence_case_enabled && 
-    !is_caps_enabled && // disable if caps is enabled
-    !process_sentence_case(keycode, record)
-  ) {
+// Runs before tap-hold keys are resolved, so combos can hold back their keys
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+  // Later stages take the keycode from the record instead of walking the layers
+  keycode_cache_pre_process(record);
+  // Home row mods typed in a streak are letters right away, combos don't see them
+  const bool speculated = speculative_tap_pre_process(keycode, record);
+  // Chordal hold sees every press, and taps a same-hand mod-tap before it
+  if (!process_chordal_hold(keycode, record)) {
     return false;
   }
+  if (speculated) {
+    return true;
+  }
+  return process_position_combos(keycode, record);
+}
 
-  // Other keys...
+// Letters for typing streaks, including åäö
+bool speculative_tap_letter(uint16_t keycode) {
+  switch (keycode) {
+    case KC_A ... KC_Z:
+    case SE_ARNG:
+    case SE_ADIA:
+    case SE_ODIA:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+  TRACE(KEY, record->event.pressed, keycode, (record->event.key.row << 8) | record->event.key.col);
+  latency_stats_record(keycode, record);
+  adaptive_tapping_record(keycode, record);
+
+  pipeline_profile_begin(keycode);
+  const bool result = feature_chain_process(keycode, record);
+  pipeline_profile_end();
+  return result;
+}
+
+static bool process_keycodes(uint16_t keycode, keyrecord_t *record) {
   switch (keycode) {
     /* LAYER MANAGEMENT */
 
@@ -577,16 +627,6 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
         return true;
       }
       break;
-    // Enter CONSTANT_CASE layer by moving to snake_case layer with shift modifier activated
-    case CK_CONSTANT: 
-      if (record->event.pressed) {
-        layer_move(_SNAKE);
-        register_mods(MOD_BIT(KC_LSFT));
-      }
-
-      return false;
-      break;
-
     // Make sure mods are cleared when moving to base layer
     case TO(_BASE):
       if (record->event.pressed) {
@@ -613,17 +653,17 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
     // Make it easier to send ~, ` and ^ on swedish layouts
     case CK_TILD: 
       if (record->event.pressed) {
-        SEND_STRING("~");
+        SEND_STRING_PACKED("~");
       }
       return false;
     case CK_GRV: 
       if (record->event.pressed) {
-        SEND_STRING("`");
+        SEND_STRING_PACKED("`");
       }
       return false;
     case CK_CIRC: 
       if (record->event.pressed) {
-        SEND_STRING("^");
+        SEND_STRING_PACKED("^");
       }
       return false;
     case ALTSWI: 
@@ -635,12 +675,29 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
       return false;
 
     /* FEATURES */
+    // Scan rate and latency stats, see features/latency_stats.h
+    case CK_LSTP:
+      if (record->event.pressed) {
+        latency_stats_print();
+      }
+      return false;
+    case CK_LSTR:
+      if (record->event.pressed) {
+        latency_stats_reset();
+      }
+      return false;
     case CK_SNTC:
       if (record->event.pressed) {
         // sentence_case_toggle();
         is_sentence_case_enabled = !is_sentence_case_enabled;
       }
       return false;
+    // Type the next identifier in a case, see features/case_mode.h
+    case CK_CAMEL ... CK_DOTC:
+      if (record->event.pressed) {
+        case_mode_on(CASE_MODE_CAMEL + (keycode - CK_CAMEL));
+      }
+      return false;
     case CK_VIM: 
       if (record->event.pressed) {
         toggle_vim_mode();
@@ -651,89 +708,108 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
 }
 
 void keyboard_post_init_user(void) {
-  debug_enable = true;
-  debug_matrix = true;
-  debug_keyboard = true;
-}
-
-void leader_end_user(void) {
-  // Screen lock
-  if(leader_sequence_one_key(KC_Q)) {
-    tap_code16(G(KC_L));
-  } else 
-  // Screen saver
-  if(leader_sequence_one_key(KC_W)) {
-    tap_code16(SCRSVR);
-  } else 
-  // D => Delete
-  if(leader_sequence_one_key(KC_D)) {
-    tap_code16(KC_DEL);
-  } else 
-  // G + U => Commit and push basic git updates
-  // NOTE: Mostly used for note-taking and writing repos, not code.
-  if(leader_sequence_two_keys(KC_G, KC_U)) {
-    SEND_STRING("git add .; git commit -m \"update\"; git push");
-  }
+  // Debug printing formats text synchronously on every scan and key press.
+  // Key and feature events go through the trace buffer instead, decode them with scripts/trace_decode.py.
+  // debug_enable = true;
+  // debug_matrix = true;
+  // debug_keyboard = true;
+
+  // Layer colors are an effect of their own, see rgb_matrix_user.inc
+  rgb_matrix_mode_noeeprom(RGB_MATRIX_CUSTOM_LEDMAP);
+
+  keycode_cache_init();
+  tap_hold_init();
+  feature_chain_init();
+  adaptive_tapping_init();
+  macro_store_init();
 }
 
-void matrix_scan_user(void) {
-  // Ensures that layer locks are disabled after some idle time
-  layer_lock_task();
+void housekeeping_task_user(void) {
+  // Ship trace records to the console in the idle part of the main loop
+  trace_buffer_task();
+  // Send this scan's keyboard report, merged from all the changes in it
+  report_coalesce_task();
 }
 
-char sentence_case_press_user(uint16_t keycode,
-                              keyrecord_t* record,
-                              uint8_t mods) {
-  if ((mods & ~(MOD_MASK_SHIFT | MOD_BIT(KC_RALT))) == 0) {
-    const bool shifted = mods & MOD_MASK_SHIFT;
-    switch (keycode) {
-      case KC_LCTL ... KC_RGUI:  // Mod keys.
-        return '\0';  // These keys are ignored.
-
-      case KC_A ... KC_Z:
-      case SE_ARNG:
-      case SE_ADIA:
-      case SE_ODIA:
-        return 'a';  // Letter key.
-
-      case KC_DOT:  // . is punctuation, Shift . is a symbol (>)
-        return !shifted ? '.' : '#';
-      /*
-      case KC_1:
-      case KC_SLSH:
-        return shifted ? '.' : '#';
-      */
-      case KC_EXLM: // !
-        return '.';
-      case SE_QUES: // ?
-        return '.';
-        /*
-      case KC_MINS: // ?
-        return shifted ? '.' : '#';
-        */
-
-      case KC_1 ... KC_0:  // 1 2 3 4 5 6 7 8 9 0
-      /*
-      case KC_MINS ... KC_SCLN:  // - = [ ] ; backslash
-      case KC_GRV:
-      */
-      case KC_COMM:
-        return '#';  // Symbol key.
-
-      case KC_SPC:
-        return ' ';  // Space key.
-
-      // case KC_QUOT:
-      case SE_QUOT:
-        return '\'';  // Quote key.
-    }
+#ifdef LEADER_TRIE_ENABLE
+// Leader sequences are declared in leader.txt
+void leader_trie_action_user(uint8_t action) {
+  switch (action) {
+    case LEADER_SCREEN_LOCK:
+      tap_code16(G(KC_L));
+      break;
+    case LEADER_SCREEN_SAVER:
+      tap_code16(SCRSVR);
+      break;
+    case LEADER_DELETE:
+      tap_code16(KC_DEL);
+      break;
+    case LEADER_GIT_PUSH:
+      SEND_STRING_PACKED("git add .; git commit -m \"update\"; git push");
+      break;
+    case LEADER_PROFILE_PRINT:
+      pipeline_profile_print();
+      break;
+    case LEADER_PROFILE_RESET:
+      pipeline_profile_reset();
+      break;
+    case LEADER_LED_STATS:
+      led_cache_print();
+      break;
+    case LEADER_BOUNCE_PRINT:
+      eager_debounce_print();
+      break;
+    case LEADER_BOUNCE_RESET:
+      eager_debounce_reset();
+      break;
+    case LEADER_TAPPING_PRINT:
+      adaptive_tapping_print();
+      break;
+    case LEADER_TAPPING_RESET:
+      adaptive_tapping_reset();
+      break;
+    case LEADER_SPECULATION_PRINT:
+      speculative_tap_print();
+      break;
+    case LEADER_SPECULATION_RESET:
+      speculative_tap_reset();
+      break;
+    case LEADER_REPORT_PRINT:
+      report_coalesce_print();
+      break;
+    case LEADER_REPORT_RESET:
+      report_coalesce_reset();
+      break;
   }
+}
+#endif
 
-  // Otherwise clear Sentence Case to initial state.
-  sentence_case_clear();
-  return '\0';
+void matrix_scan_user(void) {
+  // Runs due feature timeouts, like disabling layer locks after some idle time
+  scheduler_task();
+  // Counts scans per second when measuring latency
+  latency_stats_task();
 }
 
+// Sentence Case key classes for the Swedish host layout. Shifted keycodes
+// like SE_QUES = S(SE_PLUS) are looked up as their base key with shift.
+// clang-format off
+const uint8_t PROGMEM sentence_case_classes[SENTENCE_CASE_CLASSES_SIZE] = {
+  [KC_A ... KC_Z] = SENTENCE_CASE_CLASS(LETTER, LETTER),
+  [SE_ARNG]       = SENTENCE_CASE_CLASS(LETTER, LETTER),
+  [SE_ADIA]       = SENTENCE_CASE_CLASS(LETTER, LETTER),
+  [SE_ODIA]       = SENTENCE_CASE_CLASS(LETTER, LETTER),
+  [KC_DOT]        = SENTENCE_CASE_CLASS(PUNCT, SYMBOL),  // . :
+  [KC_1]          = SENTENCE_CASE_CLASS(SYMBOL, PUNCT),  // 1 !
+  [SE_PLUS]       = SENTENCE_CASE_CLASS(CLEAR, PUNCT),   // + ?
+  [KC_2]          = SENTENCE_CASE_CLASS(SYMBOL, QUOTE),  // 2 "
+  [KC_3 ... KC_0] = SENTENCE_CASE_CLASS(SYMBOL, SYMBOL),
+  [KC_COMM]       = SENTENCE_CASE_CLASS(SYMBOL, SYMBOL),
+  [KC_SPC]        = SENTENCE_CASE_CLASS(SPACE, SPACE),
+  [SE_QUOT]       = SENTENCE_CASE_CLASS(QUOTE, QUOTE),
+};
+// clang-format on
+
 /*
 bool muse_mode = false;
 uint8_t last_muse_note = 0;
@@ -0,0 +1,49 @@
+// Generated by scripts/gen_leader.py from leader.txt, do not edit.
+// 15 sequences, 17 trie nodes.
+
+#pragma once
+
+#define LEADER_TRIE_NODES 17
+#define LEADER_TRIE_DEPTH 2
+
+enum leader_action {
+    LEADER_NONE,
+    LEADER_SCREEN_LOCK,
+    LEADER_SCREEN_SAVER,
+    LEADER_DELETE,
+    LEADER_GIT_PUSH,
+    LEADER_PROFILE_PRINT,
+    LEADER_PROFILE_RESET,
+    LEADER_LED_STATS,
+    LEADER_BOUNCE_PRINT,
+    LEADER_BOUNCE_RESET,
+    LEADER_TAPPING_PRINT,
+    LEADER_TAPPING_RESET,
+    LEADER_SPECULATION_PRINT,
+    LEADER_SPECULATION_RESET,
+    LEADER_REPORT_PRINT,
+    LEADER_REPORT_RESET,
+};
+
+// The trie is only defined in features/leader_trie.c.
+#ifdef LEADER_TRIE_TABLES
+
+static const uint8_t PROGMEM leader_trie_edges[] = {
+    0, 10, 11, 11, 12, 13, 13, 14, 14, 15, 16, 16,
+    16, 16, 16, 16, 16, 16,
+};
+
+static const uint8_t PROGMEM leader_trie_keys[] = {
+    KC_B, KC_D, KC_G, KC_H, KC_L, KC_P, KC_Q, KC_S,
+    KC_T, KC_W, KC_R, KC_U, KC_R, KC_R, KC_R, KC_R,
+};
+
+static const uint8_t PROGMEM leader_trie_actions[] = {
+    LEADER_NONE, LEADER_BOUNCE_PRINT, LEADER_DELETE, LEADER_NONE,
+    LEADER_REPORT_PRINT, LEADER_LED_STATS, LEADER_PROFILE_PRINT, LEADER_SCREEN_LOCK,
+    LEADER_SPECULATION_PRINT, LEADER_TAPPING_PRINT, LEADER_SCREEN_SAVER, LEADER_BOUNCE_RESET,
+    LEADER_GIT_PUSH, LEADER_REPORT_RESET, LEADER_PROFILE_RESET, LEADER_SPECULATION_RESET,
+    LEADER_TAPPING_RESET,
+};
+
+#endif  // LEADER_TRIE_TABLES
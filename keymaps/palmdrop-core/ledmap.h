@@ -0,0 +1,30 @@
+// Generated by scripts/gen_ledmap.py from ledmap.txt and keymap.c, do not edit.
+
+#pragma once
+
+static const uint8_t PROGMEM ledmap_palette[][3] = {
+    {0x07, 0x00, 0x00},  // base
+    {0x01, 0x00, 0x00},  // lbase
+    {0xFF, 0xFF, 0x00},  // sys
+    {0xFF, 0x00, 0x00},  // warn
+};
+
+static const uint8_t PROGMEM ledmap_rows[] = {
+    [_BASE] = 0,
+    [_ADJUST] = 1,
+};
+
+static const uint8_t PROGMEM ledmap[][RGB_MATRIX_LED_COUNT] = {
+    [0] = {  // _BASE
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0,
+    },
+    [1] = {  // _ADJUST
+        0, 0, 2, 2, 2, 0, 0, 2, 2, 0, 2, 0,
+        0, 0, 2, 2, 2, 0, 0, 2, 2, 2, 0, 3,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 0,
+        0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0,
+    },
+};
@@ -4,19 +4,139 @@ AUDIO_ENABLE = no
 
 # RGB_MATRIX_ENABLE = no
 
+# Layer colors are an effect of their own that only writes LEDs whose color changed, see rgb_matrix_user.inc
+RGB_MATRIX_CUSTOM_USER = yes
+
 MOUSEKEY_ENABLE = yes
-COMBO_ENABLE = yes
-TAP_DANCE_ENABLE = yes 
 AUTO_SHIFT_ENABLE = yes
 REPEAT_KEY_ENABLE = yes
-DYNAMIC_MACRO_ENABLE = yes
 CAPS_WORD_ENABLE = yes
-LEADER_ENABLE = yes
+# Tap dances that send their single tap on press instead of after the tapping term
+EAGER_TAP_DANCE_ENABLE = yes
+# Macros in 8 slots, compactly encoded and saved to EEPROM, instead of QMK's dynamic macros
+MACRO_STORE_ENABLE = yes
+# Combos from combos.txt, matched on key positions instead of by QMK's combos
+POSITION_COMBOS_ENABLE = yes
+# Leader sequences from leader.txt, matched eagerly instead of by QMK's leader
+LEADER_TRIE_ENABLE = yes
 
 CONSOLE_ENABLE = yes
 
+# Binary trace records instead of debug printing, see features/trace_buffer.h
+TRACE_BUFFER_ENABLE = yes
+
+# Per-stage latency of process_record_user, dumped with leader + P
+PIPELINE_PROFILE_ENABLE = no
+
+# Per-key debounce, eager on press, with bounce statistics dumped with leader + B
+EAGER_DEBOUNCE_ENABLE = yes
+
+# Tapping terms of home row mods and layer-taps learned from typing, dumped with leader + T
+ADAPTIVE_TAPPING_ENABLE = yes
+
+# Home row mods typed in a streak resolve to their letter on press, wrong guesses dumped with leader + S
+SPECULATIVE_TAP_ENABLE = yes
+
+# Home row mods only hold when chorded with a key of the other hand, same-hand rolls are taps
+CHORDAL_HOLD_ENABLE = yes
+
+# Identifiers typed as words in camelCase, snake_case, kebab-case etc., instead of a layer per case
+CASE_MODE_ENABLE = yes
+
+# Keycodes resolved under the active layers kept in RAM and set on records, benchmarked with ./scripts/host.sh palmdrop-core -l 6
+KEYCODE_CACHE_ENABLE = yes
+
+# SEND_STRING_PACKED presses runs of distinct keys in one report instead of a report per character
+PACKED_STRING_ENABLE = yes
+
+# Keyboard reports merged and sent once per scan, sent and saved counts dumped with leader + H
+REPORT_COALESCE_ENABLE = yes
+
+# Scan rate and press-to-report latency histograms, dumped from the _ADJUST layer
+LATENCY_STATS_ENABLE = no
+
+SRC += features/scheduler.c
 SRC += features/layer_lock.c
 SRC += features/sentence_case.c
+SRC += features/tap_hold_table.c
+SRC += features/feature_chain.c
+SRC += features/driver_wrap.c
+
+ifeq ($(strip $(TRACE_BUFFER_ENABLE)), yes)
+    SRC += features/trace_buffer.c
+    OPT_DEFS += -DTRACE_BUFFER_ENABLE
+endif
+
+ifeq ($(strip $(PIPELINE_PROFILE_ENABLE)), yes)
+    SRC += features/pipeline_profile.c
+    OPT_DEFS += -DPIPELINE_PROFILE_ENABLE
+endif
+
+ifeq ($(strip $(EAGER_DEBOUNCE_ENABLE)), yes)
+    DEBOUNCE_TYPE = custom
+    SRC += features/eager_debounce.c
+    OPT_DEFS += -DEAGER_DEBOUNCE_ENABLE
+endif
+
+ifeq ($(strip $(EAGER_TAP_DANCE_ENABLE)), yes)
+    SRC += features/eager_tap_dance.c
+    OPT_DEFS += -DEAGER_TAP_DANCE_ENABLE
+endif
+
+ifeq ($(strip $(MACRO_STORE_ENABLE)), yes)
+    SRC += features/macro_store.c
+    OPT_DEFS += -DMACRO_STORE_ENABLE
+endif
+
+ifeq ($(strip $(POSITION_COMBOS_ENABLE)), yes)
+    SRC += features/position_combos.c
+    OPT_DEFS += -DPOSITION_COMBOS_ENABLE
+endif
+
+ifeq ($(strip $(LEADER_TRIE_ENABLE)), yes)
+    SRC += features/leader_trie.c
+    OPT_DEFS += -DLEADER_TRIE_ENABLE
+endif
+
+ifeq ($(strip $(ADAPTIVE_TAPPING_ENABLE)), yes)
+    SRC += features/adaptive_tapping.c
+    OPT_DEFS += -DADAPTIVE_TAPPING_ENABLE
+endif
+
+ifeq ($(strip $(SPECULATIVE_TAP_ENABLE)), yes)
+    SRC += features/speculative_tap.c
+    OPT_DEFS += -DSPECULATIVE_TAP_ENABLE
+endif
+
+ifeq ($(strip $(CHORDAL_HOLD_ENABLE)), yes)
+    SRC += features/chordal_hold.c
+    OPT_DEFS += -DCHORDAL_HOLD_ENABLE
+endif
+
+ifeq ($(strip $(CASE_MODE_ENABLE)), yes)
+    SRC += features/case_mode.c
+    OPT_DEFS += -DCASE_MODE_ENABLE
+endif
+
+ifeq ($(strip $(KEYCODE_CACHE_ENABLE)), yes)
+    SRC += features/keycode_cache.c
+    OPT_DEFS += -DKEYCODE_CACHE_ENABLE
+endif
+
+ifeq ($(strip $(PACKED_STRING_ENABLE)), yes)
+    SRC += features/packed_string.c
+    OPT_DEFS += -DPACKED_STRING_ENABLE
+endif
+
+ifeq ($(strip $(REPORT_COALESCE_ENABLE)), yes)
+    SRC += features/report_coalesce.c
+    OPT_DEFS += -DREPORT_COALESCE_ENABLE
+endif
+
+ifeq ($(strip $(LATENCY_STATS_ENABLE)), yes)
+    SRC += features/latency_stats.c
+    OPT_DEFS += -DLATENCY_STATS_ENABLE
+endif
 
 ifeq ($(strip $(AUDIO_ENABLE)), yes)
     SRC += muse.c
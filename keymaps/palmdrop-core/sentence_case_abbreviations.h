@@ -0,0 +1,140 @@
+// Generated by scripts/gen_abbreviations.py from abbreviations.txt, do not edit.
+// 190 abbreviations, 567 trie nodes.
+
+#pragma once
+
+#define SENTENCE_CASE_TRIE_NODES 567
+
+static const uint16_t PROGMEM sentence_case_trie_edges[] = {
+    0, 26, 36, 41, 46, 53, 62, 69, 71, 72, 75, 79,
+    82, 86, 98, 101, 110, 116, 117, 119, 128, 134, 137, 142,
+    143, 144, 145, 146, 147, 148, 151, 152, 154, 157, 158, 159,
+    162, 165, 166, 167, 169, 170, 172, 174, 175, 177, 178, 180,
+    182, 183, 184, 185, 186, 187, 189, 191, 192, 194, 196, 197,
+    199, 200, 202, 205, 206, 208, 209, 211, 212, 214, 218, 219,
+    220, 221, 222, 224, 227, 228, 229, 230, 231, 232, 233, 234,
+    236, 237, 239, 240, 241, 242, 243, 244, 245, 246, 247, 249,
+    250, 251, 252, 257, 259, 260, 261, 262, 263, 264, 265, 266,
+    267, 268, 269, 272, 273, 274, 275, 277, 278, 281, 282, 283,
+    285, 287, 288, 289, 291, 292, 293, 295, 296, 298, 299, 300,
+    302, 303, 304, 308, 309, 310, 313, 314, 315, 316, 317, 318,
+    319, 321, 322, 323, 324, 325, 326, 327, 328, 328, 329, 330,
+    332, 333, 334, 337, 338, 339, 340, 341, 342, 343, 344, 345,
+    346, 347, 348, 348, 349, 350, 351, 351, 351, 352, 352, 353,
+    354, 354, 355, 356, 357, 358, 358, 359, 360, 361, 362, 363,
+    363, 363, 364, 365, 366, 366, 367, 368, 368, 368, 369, 370,
+    371, 372, 373, 375, 377, 378, 379, 380, 382, 382, 383, 383,
+    384, 385, 386, 387, 388, 390, 390, 391, 393, 394, 395, 396,
+    397, 398, 399, 399, 400, 401, 401, 401, 402, 402, 402, 403,
+    403, 404, 405, 406, 407, 408, 409, 409, 410, 411, 411, 411,
+    411, 412, 413, 414, 415, 416, 417, 418, 419, 419, 420, 421,
+    422, 423, 424, 425, 425, 426, 426, 428, 429, 430, 431, 432,
+    432, 433, 434, 434, 435, 436, 437, 438, 438, 439, 440, 441,
+    442, 443, 444, 445, 445, 445, 445, 446, 446, 447, 448, 449,
+    450, 450, 451, 452, 453, 453, 454, 455, 456, 457, 458, 459,
+    460, 461, 462, 463, 464, 466, 466, 467, 467, 468, 468, 469,
+    469, 470, 471, 471, 471, 471, 471, 471, 472, 473, 473, 473,
+    474, 475, 476, 476, 476, 476, 476, 476, 477, 477, 477, 477,
+    478, 479, 479, 480, 481, 482, 483, 484, 484, 485, 485, 485,
+    485, 485, 486, 486, 486, 487, 487, 487, 487, 487, 488, 489,
+    489, 489, 490, 491, 491, 492, 492, 494, 495, 495, 496, 497,
+    498, 498, 499, 499, 499, 499, 500, 500, 501, 502, 502, 503,
+    503, 504, 505, 505, 505, 506, 507, 507, 507, 507, 508, 508,
+    508, 508, 509, 509, 509, 509, 510, 511, 512, 512, 513, 513,
+    513, 513, 513, 513, 513, 514, 514, 514, 515, 515, 516, 517,
+    517, 518, 519, 520, 521, 521, 521, 521, 522, 523, 523, 524,
+    524, 524, 524, 524, 524, 525, 525, 525, 525, 525, 526, 527,
+    527, 528, 528, 528, 529, 529, 529, 529, 530, 530, 531, 531,
+    532, 532, 532, 532, 532, 533, 533, 533, 534, 534, 535, 535,
+    535, 535, 535, 535, 535, 535, 535, 536, 536, 536, 536, 536,
+    536, 536, 537, 538, 539, 539, 540, 540, 540, 540, 540, 540,
+    540, 541, 542, 543, 543, 544, 544, 545, 545, 546, 546, 546,
+    547, 548, 549, 549, 549, 549, 550, 550, 550, 550, 551, 551,
+    551, 552, 552, 552, 552, 553, 554, 554, 554, 554, 555, 556,
+    556, 557, 557, 558, 559, 560, 560, 560, 560, 561, 561, 561,
+    561, 561, 561, 561, 562, 563, 563, 563, 564, 564, 564, 565,
+    565, 566, 566, 566,
+};
+
+static const uint8_t PROGMEM sentence_case_trie_keys[] = {
+    KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H,
+    KC_I, KC_J, KC_K, KC_L, KC_M, KC_N, KC_O, KC_P,
+    KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W, KC_Y,
+    KC_SCLN, KC_QUOT, KC_B, KC_C, KC_D, KC_L, KC_N, KC_P,
+    KC_S, KC_U, KC_V, KC_DOT, KC_E, KC_I, KC_L, KC_R,
+    KC_DOT, KC_A, KC_F, KC_H, KC_M, KC_O, KC_E, KC_I,
+    KC_O, KC_R, KC_V, KC_Y, KC_DOT, KC_D, KC_L, KC_N,
+    KC_Q, KC_S, KC_T, KC_V, KC_X, KC_DOT, KC_E, KC_I,
+    KC_O, KC_R, KC_T, KC_SCLN, KC_DOT, KC_G, KC_O, KC_R,
+    KC_B, KC_N, KC_DOT, KC_A, KC_F, KC_R, KC_U, KC_A,
+    KC_L, KC_R, KC_B, KC_R, KC_T, KC_SCLN, KC_E, KC_F,
+    KC_G, KC_H, KC_I, KC_M, KC_O, KC_R, KC_S, KC_T,
+    KC_LBRC, KC_DOT, KC_O, KC_R, KC_DOT, KC_B, KC_C, KC_K,
+    KC_M, KC_N, KC_P, KC_S, KC_Z, KC_DOT, KC_G, KC_H,
+    KC_P, KC_R, KC_T, KC_DOT, KC_T, KC_D, KC_E, KC_E,
+    KC_G, KC_I, KC_K, KC_Q, KC_R, KC_T, KC_SCLN, KC_DOT,
+    KC_E, KC_F, KC_I, KC_O, KC_R, KC_DOT, KC_N, KC_P,
+    KC_DOT, KC_A, KC_I, KC_O, KC_S, KC_DOT, KC_K, KC_R,
+    KC_DOT, KC_V, KC_B, KC_A, KC_J, KC_R, KC_V, KC_DOT,
+    KC_G, KC_M, KC_P, KC_R, KC_T, KC_S, KC_G, KC_D,
+    KC_E, KC_G, KC_A, KC_K, KC_M, KC_T, KC_L, KC_V,
+    KC_DOT, KC_DOT, KC_A, KC_S, KC_P, KC_DOT, KC_DOT, KC_A,
+    KC_DOT, KC_D, KC_R, KC_DOT, KC_C, KC_P, KC_R, KC_C,
+    KC_DOT, KC_S, KC_L, KC_V, KC_Y, KC_S, KC_DOT, KC_DOT,
+    KC_C, KC_L, KC_S, KC_DOT, KC_P, KC_C, KC_DOT, KC_DOT,
+    KC_C, KC_K, KC_D, KC_G, KC_K, KC_B, KC_G, KC_L,
+    KC_R, KC_E, KC_DOT, KC_DOT, KC_R, KC_DOT, KC_D, KC_K,
+    KC_N, KC_SCLN, KC_R, KC_V, KC_DOT, KC_I, KC_C, KC_K,
+    KC_E, KC_O, KC_S, KC_N, KC_R, KC_DOT, KC_R, KC_N,
+    KC_DOT, KC_DOT, KC_S, KC_DOT, KC_DOT, KC_D, KC_DOT, KC_R,
+    KC_D, KC_L, KC_R, KC_A, KC_S, KC_DOT, KC_M, KC_S,
+    KC_DOT, KC_DOT, KC_DOT, KC_N, KC_A, KC_F, KC_H, KC_M,
+    KC_S, KC_S, KC_V, KC_DOT, KC_B, KC_S, KC_T, KC_T,
+    KC_K, KC_S, KC_DOT, KC_V, KC_DOT, KC_D, KC_L, KC_S,
+    KC_A, KC_DOT, KC_DOT, KC_E, KC_O, KC_DOT, KC_G, KC_M,
+    KC_S, KC_Y, KC_DOT, KC_P, KC_S, KC_K, KC_P, KC_T,
+    KC_D, KC_R, KC_DOT, KC_DOT, KC_DOT, KC_S, KC_DOT, KC_N,
+    KC_A, KC_K, KC_L, KC_DOT, KC_M, KC_S, KC_R, KC_DOT,
+    KC_E, KC_H, KC_O, KC_V, KC_G, KC_P, KC_A, KC_K,
+    KC_S, KC_R, KC_Z, KC_L, KC_DOT, KC_G, KC_DOT, KC_S,
+    KC_DOT, KC_H, KC_DOT, KC_R, KC_D, KC_DOT, KC_DOT, KC_DOT,
+    KC_DOT, KC_DOT, KC_R, KC_T, KC_DOT, KC_DOT, KC_N, KC_O,
+    KC_T, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT,
+    KC_DOT, KC_DOT, KC_D, KC_A, KC_DOT, KC_C, KC_T, KC_P,
+    KC_R, KC_P, KC_DOT, KC_T, KC_DOT, KC_DOT, KC_DOT, KC_DOT,
+    KC_DOT, KC_DOT, KC_DOT, KC_L, KC_DOT, KC_DOT, KC_DOT, KC_DOT,
+    KC_L, KC_L, KC_DOT, KC_DOT, KC_R, KC_R, KC_DOT, KC_S,
+    KC_DOT, KC_DOT, KC_T, KC_DOT, KC_A, KC_O, KC_F, KC_DOT,
+    KC_R, KC_DOT, KC_DOT, KC_DOT, KC_T, KC_DOT, KC_D, KC_L,
+    KC_DOT, KC_L, KC_DOT, KC_DOT, KC_T, KC_DOT, KC_DOT, KC_DOT,
+    KC_D, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT,
+    KC_C, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_L, KC_DOT, KC_DOT,
+    KC_C, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_R,
+    KC_DOT, KC_DOT, KC_Y, KC_DOT, KC_I, KC_DOT, KC_DOT, KC_D,
+    KC_S, KC_F, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_R, KC_P,
+    KC_DOT, KC_T, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT,
+    KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_S, KC_X, KC_DOT, KC_DOT,
+    KC_DOT, KC_DOT, KC_L, KC_DOT, KC_DOT, KC_DOT, KC_D, KC_DOT,
+    KC_S, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_O,
+    KC_DOT, KC_DOT, KC_C, KC_DOT, KC_A, KC_DOT, KC_DOT, KC_DOT,
+    KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_S, KC_DOT, KC_DOT,
+    KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_K, KC_M, KC_S, KC_DOT,
+    KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_DOT, KC_M,
+    KC_DOT, KC_K, KC_DOT, KC_D, KC_DOT, KC_O, KC_DOT, KC_A,
+    KC_DOT, KC_DOT, KC_L, KC_K, KC_V, KC_DOT, KC_DOT, KC_DOT,
+    KC_A, KC_DOT, KC_DOT, KC_DOT, KC_S, KC_DOT, KC_DOT, KC_M,
+    KC_DOT, KC_DOT, KC_DOT, KC_V, KC_X, KC_DOT, KC_DOT, KC_DOT,
+    KC_A, KC_A, KC_DOT, KC_M, KC_DOT, KC_F, KC_A, KC_R,
+    KC_DOT, KC_DOT, KC_DOT, KC_N, KC_DOT, KC_DOT, KC_DOT, KC_DOT,
+    KC_DOT, KC_DOT, KC_N, KC_G, KC_DOT, KC_DOT, KC_N, KC_DOT,
+    KC_DOT, KC_D, KC_DOT, KC_D, KC_DOT, KC_DOT,
+};
+
+static const uint8_t PROGMEM sentence_case_trie_accept[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0xC6, 0x12, 0x82,
+    0x91, 0x01, 0x58, 0x20, 0x40, 0xB6, 0x40, 0x0E, 0x10, 0x28, 0x48, 0x08,
+    0xB8, 0x10, 0x01, 0xA0, 0xCA, 0x67, 0x7C, 0x27, 0xE8, 0xED, 0x99, 0x12,
+    0x5D, 0xCA, 0xDC, 0x1D, 0xFD, 0x96, 0x70, 0xFA, 0x9E, 0x76, 0xF5, 0xD6,
+    0xBF, 0x1F, 0xFD, 0xA8, 0xC6, 0xDD, 0xCE, 0x29, 0xEE, 0x67, 0x6B,
+};
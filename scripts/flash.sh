@@ -1,5 +1,9 @@
 #!/bin/bash
 
 . ./scripts/link.sh $1
+python3 scripts/gen_abbreviations.py $1 || exit 1
+python3 scripts/gen_ledmap.py $1 || exit 1
+python3 scripts/gen_leader.py $1 || exit 1
+python3 scripts/gen_combos.py $1 || exit 1
 qmk flash -j 0 -kb planck/ez/glow -km palmdrop
 . ./scripts/clean.sh
\ No newline at end of file
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+
+"""Compiles the Sentence Case abbreviation list into a PROGMEM trie.
+
+Reads keymaps/<keymap>/abbreviations.txt, one abbreviation per line ('#'
+starts a comment), if the keymap has one, and writes
+keymaps/<keymap>/sentence_case_abbreviations.h for features/sentence_case.c.
+Abbreviations are matched case-insensitively from the start of a word, e.g.
+"t.ex." or "vs.", and the dots in them are part of the pattern.
+
+The trie is stored as three tables with nodes numbered breadth first. Since
+every node but the root has exactly one incoming edge, the edges are numbered
+in the same order and edge `e` always leads to node `e + 1`:
+
+  sentence_case_trie_edges[n] ... sentence_case_trie_edges[n + 1] - 1
+      are the outgoing edges of node `n`, sorted by keycode.
+  sentence_case_trie_keys[e]
+      is the keycode of edge `e`.
+  sentence_case_trie_accept[n / 8] & (1 << (n % 8))
+      is set if the path to node `n` spells a complete abbreviation.
+
+Usage: python3 scripts/gen_abbreviations.py <keymap>
+"""
+
+import os
+import sys
+
+# Characters that may appear in abbreviations and the keycodes typing them on
+# a Swedish host layout.
+KEYCODES = {c: "KC_" + c.upper() for c in "abcdefghijklmnopqrstuvwxyz"}
+KEYCODES.update({
+    ".": "KC_DOT",
+    "å": "KC_LBRC",
+    "ä": "KC_QUOT",
+    "ö": "KC_SCLN",
+})
+
+# Value of each keycode in KEYCODES, used to sort the edges of a node.
+KEYCODE_VALUES = {"KC_" + c.upper(): 0x04 + i
+                  for i, c in enumerate("abcdefghijklmnopqrstuvwxyz")}
+KEYCODE_VALUES.update({
+    "KC_DOT": 0x37,
+    "KC_LBRC": 0x2F,
+    "KC_QUOT": 0x34,
+    "KC_SCLN": 0x33,
+})
+
+
+def load_abbreviations(path):
+    abbreviations = set()
+    with open(path, encoding="utf-8") as file:
+        for line_number, line in enumerate(file, 1):
+            word = line.split("#", 1)[0].strip().lower()
+            if not word:
+                continue
+            for c in word:
+                if c not in KEYCODES:
+                    sys.exit(f"{path}:{line_number}: cannot type {c!r}")
+            if not word.endswith("."):
+                sys.exit(f"{path}:{line_number}: {word!r} must end with '.'")
+            abbreviations.add(word)
+    return sorted(abbreviations)
+
+
+def build_trie(abbreviations):
+    root = {}
+    for word in abbreviations:
+        node = root
+        for c in word:
+            node = node.setdefault(KEYCODES[c], {})
+        node[None] = True  # Accepting.
+
+    edges = []
+    keys = []
+    accept = []
+    queue = [root]
+    for node in queue:  # Appending while iterating gives breadth first order.
+        edges.append(len(keys))
+        accept.append(None in node)
+        children = sorted((k for k in node if k is not None),
+                          key=KEYCODE_VALUES.get)
+        for keycode in children:
+            keys.append(keycode)
+            queue.append(node[keycode])
+    edges.append(len(keys))
+    return edges, keys, accept
+
+
+def format_table(items, per_line):
+    lines = []
+    for i in range(0, len(items), per_line):
+        lines.append("    " + " ".join(f"{item}," for item in items[i:i + per_line]))
+    return "\n".join(lines)
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__.strip().splitlines()[-1])
+    keymap_dir = os.path.join(os.path.dirname(__file__), "..", "keymaps",
+                              sys.argv[1])
+    source = os.path.join(keymap_dir, "abbreviations.txt")
+    if not os.path.exists(source):
+        return  # Keymap doesn't use the abbreviation trie.
+    abbreviations = load_abbreviations(source)
+    edges, keys, accept = build_trie(abbreviations)
+    if len(edges) > 0xFFFF:
+        sys.exit("too many abbreviations for 16-bit trie nodes")
+
+    accept_bits = [0] * ((len(accept) + 7) // 8)
+    for node, accepting in enumerate(accept):
+        if accepting:
+            accept_bits[node // 8] |= 1 << (node % 8)
+
+    output = f"""\
+// Generated by scripts/gen_abbreviations.py from abbreviations.txt, do not edit.
+// {len(abbreviations)} abbreviations, {len(accept)} trie nodes.
+
+#pragma once
+
+#define SENTENCE_CASE_TRIE_NODES {len(accept)}
+
+static const uint16_t PROGMEM sentence_case_trie_edges[] = {{
+{format_table([str(e) for e in edges], 12)}
+}};
+
+static const uint8_t PROGMEM sentence_case_trie_keys[] = {{
+{format_table(keys, 8)}
+}};
+
+static const uint8_t PROGMEM sentence_case_trie_accept[] = {{
+{format_table([f"0x{b:02X}" for b in accept_bits], 12)}
+}};
+"""
+    path = os.path.join(keymap_dir, "sentence_case_abbreviations.h")
+    with open(path, "w") as file:
+        file.write(output)
+
+
+if __name__ == "__main__":
+    main()
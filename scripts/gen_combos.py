@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+
+"""Compiles the combo table into a per-position candidate index.
+
+Reads keymaps/<keymap>/combos.txt, if the keymap has one, together with the
+first (default) layer of `keymaps` in keymap.c, and writes
+keymaps/<keymap>/combo_table.h for features/position_combos.c. Every line
+('#' starts a comment) declares one combo:
+
+  <key> <key> [<key> ...] <keycode> [<term>]
+
+Keys are keycodes as written in the default layer, like HR_S, or "row,col"
+positions on the 4x12 grid. The keycode is what the combo sends, written as
+in keymap.c. The term is how long in ms the keys may take to all go down,
+COMBO_TERM if left out.
+
+Combos are matched on matrix positions. For every position, the index holds
+a bitmask of the combos that contain it, so a key in no combo is never
+buffered:
+
+  position_combo_index[row][col]  Bitmask of the combos with a key there.
+  position_combo_sizes[c]         Number of keys of combo `c`.
+  position_combo_keycodes[c]      Keycode combo `c` sends.
+  position_combo_terms[c]         Term of combo `c` in ms.
+
+Usage: python3 scripts/gen_combos.py <keymap>
+"""
+
+import os
+import re
+import sys
+
+sys.dont_write_bytecode = True  # No __pycache__ next to the scripts.
+from gen_ledmap import parse_layers  # noqa: E402
+
+MATRIX_ROWS = 8
+MATRIX_COLS = 6
+MASK_TYPES = ((8, "uint8_t"), (16, "uint16_t"), (32, "uint32_t"))
+
+
+def matrix_position(row, col):
+    """Matrix position of a 4x12 grid key: the right half is rows 4-7."""
+    return (row, col) if col < MATRIX_COLS else (row + 4, col - MATRIX_COLS)
+
+
+def key_position(key, layer, where):
+    if re.fullmatch(r"\d+,\d+", key):
+        row, col = map(int, key.split(","))
+        if row >= 4 or col >= 12:
+            sys.exit(f"{where}: {key} is not on the 4x12 grid")
+        return matrix_position(row, col)
+    matches = [i for i, keycode in enumerate(layer) if keycode == key]
+    if len(matches) != 1:
+        sys.exit(f"{where}: {key} is on {len(matches)} keys of the default "
+                 "layer, use a row,col position")
+    return matrix_position(*divmod(matches[0], 12))
+
+
+def load_combos(path, layer):
+    combos = []
+    with open(path, encoding="utf-8") as file:
+        for line_number, line in enumerate(file, 1):
+            fields = line.split("#", 1)[0].split()
+            where = f"{path}:{line_number}"
+            if not fields:
+                continue
+            term = "COMBO_TERM"
+            if fields[-1].isdigit():
+                term = fields.pop()
+                if not 0 < int(term) < 256:
+                    sys.exit(f"{where}: terms are 1 to 255 ms")
+            if len(fields) < 3:
+                sys.exit(f"{where}: expected two or more keys and a keycode")
+            positions = [key_position(key, layer, where) for key in fields[:-1]]
+            if len(set(positions)) != len(positions):
+                sys.exit(f"{where}: duplicate key")
+            if any(sorted(positions) == sorted(c[0]) for c in combos):
+                sys.exit(f"{where}: duplicate combo")
+            combos.append((positions, fields[-1], term, " ".join(fields[:-1])))
+    return combos
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__.strip().splitlines()[-1])
+    keymap_dir = os.path.join(os.path.dirname(__file__), "..", "keymaps",
+                              sys.argv[1])
+    source = os.path.join(keymap_dir, "combos.txt")
+    if not os.path.exists(source):
+        return  # Keymap doesn't use position combos.
+    layers = parse_layers(os.path.join(keymap_dir, "keymap.c"))
+    combos = load_combos(source, next(iter(layers.values())))
+    if not combos:
+        sys.exit(f"{source}: no combos")
+    mask_type = next((t for bits, t in MASK_TYPES if len(combos) <= bits), None)
+    if not mask_type:
+        sys.exit(f"{source}: more than 32 combos")
+
+    index = [[0] * MATRIX_COLS for _ in range(MATRIX_ROWS)]
+    for i, (positions, _, _, _) in enumerate(combos):
+        for row, col in positions:
+            index[row][col] |= 1 << i
+    digits = (len(combos) + 3) // 4
+    index_lines = "\n".join(
+        "    {" + ", ".join(f"0x{mask:0{digits}X}" for mask in row) + "},"
+        for row in index)
+    combo_lines = lambda column: "\n".join(
+        f"    {column(combo)},  // {combo[3]}" for combo in combos)
+
+    output = f"""\
+// Generated by scripts/gen_combos.py from combos.txt and keymap.c, do not edit.
+
+#pragma once
+
+#define POSITION_COMBO_COUNT {len(combos)}
+#define POSITION_COMBO_MAX_SIZE {max(len(c[0]) for c in combos)}
+
+typedef {mask_type} position_combo_mask_t;
+
+// The tables are only defined in features/position_combos.c.
+#ifdef POSITION_COMBO_TABLES
+
+static const position_combo_mask_t PROGMEM
+    position_combo_index[MATRIX_ROWS][MATRIX_COLS] = {{
+{index_lines}
+}};
+
+static const uint8_t PROGMEM position_combo_sizes[] = {{
+{combo_lines(lambda c: len(c[0]))}
+}};
+
+static const uint16_t PROGMEM position_combo_keycodes[] = {{
+{combo_lines(lambda c: c[1])}
+}};
+
+static const uint8_t PROGMEM position_combo_terms[] = {{
+{combo_lines(lambda c: c[2])}
+}};
+
+#endif  // POSITION_COMBO_TABLES
+"""
+    path = os.path.join(keymap_dir, "combo_table.h")
+    with open(path, "w") as file:
+        file.write(output)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+
+"""Compiles the leader sequence table into a PROGMEM trie.
+
+Reads keymaps/<keymap>/leader.txt, if the keymap has one, and writes
+keymaps/<keymap>/leader_sequences.h, with the actions for keymap.c and the trie
+for features/leader_trie.c. Every line
+('#' starts a comment) declares one sequence and the action it runs:
+
+  <key> [<key> ...] <action>
+
+Keys are letters, digits or keycode names like KC_SCLN. Actions become
+`LEADER_<ACTION>` values of `enum leader_action`, which the keymap handles in
+`leader_trie_action_user()`. A sequence may be a prefix of another one, e.g.
+"P print" and "P R reset".
+
+The trie is stored like the Sentence Case abbreviation trie, see
+gen_abbreviations.py, with nodes and edges numbered breadth first, so that
+edge `e` leads to node `e + 1`:
+
+  leader_trie_edges[n] ... leader_trie_edges[n + 1] - 1
+      are the outgoing edges of node `n`, sorted by keycode.
+  leader_trie_keys[e]
+      is the keycode of edge `e`.
+  leader_trie_actions[n]
+      is the action of the sequence ending at node `n`, or LEADER_NONE.
+
+Usage: python3 scripts/gen_leader.py <keymap>
+"""
+
+import os
+import re
+import sys
+
+# Basic keycodes a sequence may contain, and their values.
+KEYCODE_VALUES = {"KC_" + c: 0x04 + i
+                  for i, c in enumerate("ABCDEFGHIJKLMNOPQRSTUVWXYZ")}
+KEYCODE_VALUES.update({"KC_" + c: 0x1E + i
+                       for i, c in enumerate("1234567890")})
+KEYCODE_VALUES.update({
+    "KC_ENTER": 0x28, "KC_ESCAPE": 0x29, "KC_BACKSPACE": 0x2A, "KC_TAB": 0x2B,
+    "KC_SPACE": 0x2C, "KC_MINUS": 0x2D, "KC_EQUAL": 0x2E, "KC_LBRC": 0x2F,
+    "KC_RBRC": 0x30, "KC_BSLS": 0x31, "KC_SCLN": 0x33, "KC_QUOT": 0x34,
+    "KC_GRV": 0x35, "KC_COMM": 0x36, "KC_DOT": 0x37, "KC_SLSH": 0x38,
+})
+ALIASES = {"KC_ENT": "KC_ENTER", "KC_ESC": "KC_ESCAPE",
+           "KC_BSPC": "KC_BACKSPACE", "KC_SPC": "KC_SPACE",
+           "KC_MINS": "KC_MINUS", "KC_EQL": "KC_EQUAL"}
+ACTION = re.compile(r"[a-z][a-z0-9_]*")
+
+
+def keycode(key):
+    if len(key) == 1:
+        key = "KC_" + key.upper()
+    key = ALIASES.get(key, key)
+    return key if key in KEYCODE_VALUES else None
+
+
+def load_sequences(path):
+    sequences = {}
+    actions = []
+    with open(path, encoding="utf-8") as file:
+        for line_number, line in enumerate(file, 1):
+            fields = line.split("#", 1)[0].split()
+            where = f"{path}:{line_number}"
+            if not fields:
+                continue
+            if len(fields) < 2 or not ACTION.fullmatch(fields[-1]):
+                sys.exit(f"{where}: expected keys followed by a lowercase "
+                         "action name")
+            keys = tuple(keycode(key) for key in fields[:-1])
+            if None in keys:
+                sys.exit(f"{where}: unknown key in {' '.join(fields[:-1])}")
+            if keys in sequences:
+                sys.exit(f"{where}: duplicate sequence")
+            action = fields[-1]
+            if action not in actions:
+                actions.append(action)
+            sequences[keys] = action
+    return sequences, actions
+
+
+def build_trie(sequences, actions):
+    root = {}
+    for keys, action in sequences.items():
+        node = root
+        for key in keys:
+            node = node.setdefault(key, {})
+        node[None] = actions.index(action) + 1
+
+    edges = []
+    keys = []
+    node_actions = []
+    queue = [root]
+    for node in queue:  # Appending while iterating gives breadth first order.
+        edges.append(len(keys))
+        node_actions.append(node.get(None, 0))
+        children = sorted((k for k in node if k is not None),
+                          key=KEYCODE_VALUES.get)
+        for key in children:
+            keys.append(key)
+            queue.append(node[key])
+    edges.append(len(keys))
+    return edges, keys, node_actions
+
+
+def format_table(items, per_line):
+    lines = []
+    for i in range(0, len(items), per_line):
+        lines.append("    " + " ".join(f"{item}," for item in items[i:i + per_line]))
+    return "\n".join(lines)
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__.strip().splitlines()[-1])
+    keymap_dir = os.path.join(os.path.dirname(__file__), "..", "keymaps",
+                              sys.argv[1])
+    source = os.path.join(keymap_dir, "leader.txt")
+    if not os.path.exists(source):
+        return  # Keymap doesn't use the leader trie.
+    sequences, actions = load_sequences(source)
+    if not sequences:
+        sys.exit(f"{source}: no sequences")
+    edges, keys, node_actions = build_trie(sequences, actions)
+    if len(edges) > 0xFF or len(actions) > 0xFF:
+        sys.exit("too many leader sequences for 8-bit trie nodes")
+    names = ["LEADER_NONE"] + ["LEADER_" + a.upper() for a in actions]
+    action_names = [names[a] for a in node_actions]
+
+    output = f"""\
+// Generated by scripts/gen_leader.py from leader.txt, do not edit.
+// {len(sequences)} sequences, {len(node_actions)} trie nodes.
+
+#pragma once
+
+#define LEADER_TRIE_NODES {len(node_actions)}
+#define LEADER_TRIE_DEPTH {max(len(k) for k in sequences)}
+
+enum leader_action {{
+{format_table(names, 1)}
+}};
+
+// The trie is only defined in features/leader_trie.c.
+#ifdef LEADER_TRIE_TABLES
+
+static const uint8_t PROGMEM leader_trie_edges[] = {{
+{format_table([str(e) for e in edges], 12)}
+}};
+
+static const uint8_t PROGMEM leader_trie_keys[] = {{
+{format_table(keys, 8)}
+}};
+
+static const uint8_t PROGMEM leader_trie_actions[] = {{
+{format_table(action_names, 4)}
+}};
+
+#endif  // LEADER_TRIE_TABLES
+"""
+    path = os.path.join(keymap_dir, "leader_sequences.h")
+    with open(path, "w") as file:
+        file.write(output)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+
+"""Compiles the layer colors of the RGB matrix into a palette-indexed ledmap.
+
+Reads keymaps/<keymap>/ledmap.txt, if the keymap has one, together with the
+`keymaps` layers in keymap.c, and writes keymaps/<keymap>/ledmap.h for
+keymap.c. Colors are derived from the actual bindings, so they follow the
+keymap when keys move.
+
+ledmap.txt has two kinds of lines, '#' starts a comment:
+
+  color <name> <r> <g> <b>
+      Adds a palette entry, components in hex.
+  layer <layer> <default color> [<rule>=<color> ...]
+      Gives every key of the layer a color: the first matching rule, or the
+      default. A rule is a keycode as written in keymap.c with * and ?
+      wildcards, like QK_BOOT, KC_F* or LT(*), or a "row,col" position on
+      the 4x12 grid. Transparent keys only match position rules.
+
+The first layer listed is also used for all layers that aren't listed.
+
+The output stores one palette index per LED, and one row of LEDs per listed
+layer:
+
+  ledmap_palette[i]    RGB triple of palette entry i.
+  ledmap_rows[layer]   Row of `layer` in ledmap, 0 for unlisted layers.
+  ledmap[row][led]     Palette index of LED `led`.
+
+Usage: python3 scripts/gen_ledmap.py <keymap>
+"""
+
+import fnmatch
+import os
+import re
+import sys
+
+LED_COUNT = 47
+TRANSPARENT = {"_______", "KC_TRNS", "KC_TRANSPARENT"}
+LAYOUT = re.compile(r"\[\s*(\w+)\s*\]\s*=\s*LAYOUT_planck_grid\s*\(")
+
+
+def led_position(led):
+    """Grid position of an LED: 12 per row, 11 on the bottom row, where the
+    2u space bar has a single LED."""
+    if led < 36:
+        return led // 12, led % 12
+    col = led - 36
+    return 3, col if col <= 5 else col + 1
+
+
+def strip_comments(source):
+    source = re.sub(r"/\*.*?\*/", "", source, flags=re.S)
+    return re.sub(r"//[^\n]*", "", source)
+
+
+def parse_layers(path):
+    """Returns {layer name: [48 keycodes]} from the keymaps in keymap.c."""
+    source = strip_comments(open(path, encoding="utf-8").read())
+    layers = {}
+    for match in LAYOUT.finditer(source):
+        depth = 1
+        keys = []
+        key = ""
+        for c in source[match.end():]:
+            if c == "(":
+                depth += 1
+            elif c == ")":
+                depth -= 1
+                if depth == 0:
+                    break
+            if c == "," and depth == 1:
+                keys.append(key.strip())
+                key = ""
+            else:
+                key += c
+        keys.append(key.strip())
+        keys = [re.sub(r"\s+", "", k) for k in keys if k.strip()]
+        if len(keys) != 48:
+            sys.exit(f"{path}: {match.group(1)} has {len(keys)} keys, not 48")
+        layers[match.group(1)] = keys
+    return layers
+
+
+def load_spec(path):
+    palette = {}
+    layers = []
+    with open(path, encoding="utf-8") as file:
+        for line_number, line in enumerate(file, 1):
+            fields = line.split("#", 1)[0].split()
+            where = f"{path}:{line_number}"
+            if not fields:
+                continue
+            if fields[0] == "color" and len(fields) == 5:
+                palette[fields[1]] = tuple(int(v, 16) for v in fields[2:])
+            elif fields[0] == "layer" and len(fields) >= 3:
+                rules = [rule.rsplit("=", 1) for rule in fields[3:]]
+                for rule in rules:
+                    if len(rule) != 2:
+                        sys.exit(f"{where}: rules are <pattern>=<color>")
+                layers.append((fields[1], fields[2], rules, where))
+            else:
+                sys.exit(f"{where}: expected a color or layer line")
+    if not layers:
+        sys.exit(f"{path}: no layers")
+    return palette, layers
+
+
+def key_color(keycode, position, default, rules):
+    for pattern, color in rules:
+        if re.fullmatch(r"\d+,\d+", pattern):
+            if tuple(map(int, pattern.split(","))) == position:
+                return color
+        elif keycode not in TRANSPARENT and fnmatch.fnmatchcase(keycode,
+                                                                pattern):
+            return color
+    return default
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("usage: gen_ledmap.py <keymap>")
+    keymap_dir = os.path.join(os.path.dirname(__file__), "..", "keymaps",
+                              sys.argv[1])
+    source = os.path.join(keymap_dir, "ledmap.txt")
+    if not os.path.exists(source):
+        return  # Keymap doesn't use a generated ledmap.
+    palette, spec = load_spec(source)
+    keymap = parse_layers(os.path.join(keymap_dir, "keymap.c"))
+
+    names = list(palette)
+    rows = []
+    for layer, default, rules, where in spec:
+        if layer not in keymap:
+            sys.exit(f"{where}: no layer {layer} in keymap.c")
+        row = []
+        for led in range(LED_COUNT):
+            position = led_position(led)
+            color = key_color(keymap[layer][position[0] * 12 + position[1]],
+                              position, default, rules)
+            if color not in palette:
+                sys.exit(f"{where}: unknown color {color}")
+            row.append(names.index(color))
+        rows.append((layer, row))
+
+    palette_lines = "\n".join(
+        f"    {{0x{r:02X}, 0x{g:02X}, 0x{b:02X}}},  // {name}"
+        for name, (r, g, b) in palette.items())
+    layer_lines = "\n".join(f"    [{layer}] = {i},"
+                            for i, (layer, _) in enumerate(rows))
+    row_lines = []
+    for i, (layer, row) in enumerate(rows):
+        row_lines.append(f"    [{i}] = {{  // {layer}")
+        for start in range(0, LED_COUNT, 12):
+            row_lines.append("        " +
+                             " ".join(f"{v}," for v in row[start:start + 12]))
+        row_lines.append("    },")
+    row_lines = "\n".join(row_lines)
+
+    output = f"""\
+// Generated by scripts/gen_ledmap.py from ledmap.txt and keymap.c, do not edit.
+
+#pragma once
+
+static const uint8_t PROGMEM ledmap_palette[][3] = {{
+{palette_lines}
+}};
+
+static const uint8_t PROGMEM ledmap_rows[] = {{
+{layer_lines}
+}};
+
+static const uint8_t PROGMEM ledmap[][RGB_MATRIX_LED_COUNT] = {{
+{row_lines}
+}};
+"""
+    path = os.path.join(keymap_dir, "ledmap.h")
+    with open(path, "w") as file:
+        file.write(output)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# Builds a keymap natively against the stub quantum layer in host/ and replays
+# key event traces through it. Usage: ./scripts/host.sh <keymap> [host args]
+# Rules can be overridden like with `qmk compile -e`:
+#   HOST_RULES="PIPELINE_PROFILE_ENABLE=yes" ./scripts/host.sh <keymap> ...
+
+KEYMAP_DIR="keymaps/$1"
+BUILD_DIR=".build/host"
+shift
+
+# Evaluate rules.mk (without the qmk-vim include, which is stubbed) to get the
+# sources and feature flags enabled for this keymap
+RULES=$( (grep -v '^include' "${KEYMAP_DIR}/rules.mk"; printf '%s\n' \
+  '$(info $(SRC))' \
+  '$(info $(OPT_DEFS) $(foreach V,$(filter %_ENABLE RGB_MATRIX_CUSTOM_USER,$(.VARIABLES)),$(if $(filter yes,$(strip $($(V)))),-D$(V))))' \
+  'all: ; @:') | make -s -f - ${HOST_RULES}) || exit 1
+SOURCES=$(echo "${RULES}" | sed -n 1p | sed "s|[^ ]*\.c|${KEYMAP_DIR}/&|g")
+DEFINES=$(echo "${RULES}" | sed -n 2p)
+
+python3 scripts/gen_abbreviations.py "$(basename "${KEYMAP_DIR}")" || exit 1
+python3 scripts/gen_ledmap.py "$(basename "${KEYMAP_DIR}")" || exit 1
+python3 scripts/gen_leader.py "$(basename "${KEYMAP_DIR}")" || exit 1
+python3 scripts/gen_combos.py "$(basename "${KEYMAP_DIR}")" || exit 1
+
+mkdir -p "${BUILD_DIR}"
+${CC:-cc} -std=gnu11 ${CFLAGS:--O2} -Wall \
+  -Ihost -I"${KEYMAP_DIR}" -include "${KEYMAP_DIR}/config.h" -DQMK_KEYBOARD_H='"quantum.h"' ${DEFINES} \
+  "${KEYMAP_DIR}/keymap.c" ${SOURCES} host/*.c \
+  -o "${BUILD_DIR}/$(basename "${KEYMAP_DIR}")" || exit 1
+
+"${BUILD_DIR}/$(basename "${KEYMAP_DIR}")" "$@"
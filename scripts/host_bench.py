@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+
+"""Compares the host build of a keymap against another git revision.
+
+Builds the keymap at REF (from a `git archive` into .build/bench) and in the
+working tree, both with the pipeline profile enabled, replays the same host
+arguments through both (best of 5 runs each) and prints side by side:
+
+  * the per-stage and per-keycode-class averages of the pipeline profile, in
+    nanoseconds per press,
+  * the code and data size of the symbols matching -s, a stand-in for the
+    flash cost of a change (built with -Os like the firmware by default).
+
+Usage: python3 scripts/host_bench.py <keymap> <ref> [-s REGEX] [host args]
+
+Example, comparing Sentence Case before and after a change:
+
+  python3 scripts/host_bench.py palmdrop-core HEAD~1 \\
+      -s 'sentence|transitions|trie' -n 200 host/traces/prose.trace
+"""
+
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+BENCH_DIR = os.path.join(ROOT, ".build", "bench")
+PROFILE_ROW = re.compile(r"^(\S.*?)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)\s+(\d+)$")
+NS_PER_EVENT = re.compile(r"^ns/event\s+min \d+\s+avg ([\d.]+)")
+ROUNDS = 5
+
+
+def build(tree, keymap):
+    """Builds the host binary in `tree` and returns its path."""
+    binary = os.path.join(tree, ".build", "host", keymap)
+    if os.path.exists(binary):
+        os.remove(binary)
+    env = dict(os.environ)
+    env["HOST_RULES"] = (env.get("HOST_RULES", "") +
+                         " PIPELINE_PROFILE_ENABLE=yes").strip()
+    env.setdefault("CFLAGS", "-Os")
+    # host.sh runs the binary right away, which fails without events.
+    subprocess.run(["bash", "scripts/host.sh", keymap], cwd=tree, env=env,
+                   stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+    if not os.path.exists(binary):
+        sys.exit(f"{tree}: host build failed")
+    return binary
+
+
+def run(binary, args):
+    """Replays `args` and returns the profile averages and ns per event."""
+    result = subprocess.run([binary, "-p"] + args, cwd=ROOT,
+                            stdout=subprocess.DEVNULL, stderr=subprocess.PIPE,
+                            text=True)
+    if result.returncode != 0:
+        sys.exit(result.stderr)
+    averages = {}
+    ns_per_event = None
+    for line in result.stderr.splitlines():
+        match = NS_PER_EVENT.match(line)
+        if match:
+            ns_per_event = float(match.group(1))
+            continue
+        match = PROFILE_ROW.match(line)
+        if match:
+            averages[match.group(1)] = int(match.group(4))
+    return averages, ns_per_event
+
+
+def best_of(binary, args, profile, ns_per_event):
+    """Runs `binary` once more, keeping the minimum of every average."""
+    new_profile, new_ns = run(binary, args)
+    for name, average in new_profile.items():
+        profile[name] = min(average, profile.get(name, average))
+    if ns_per_event is not None:
+        new_ns = min(new_ns, ns_per_event)
+    return profile, new_ns
+
+
+def symbol_sizes(binary, pattern):
+    """Returns the size of every code and data symbol matching `pattern`."""
+    output = subprocess.run(["nm", "-S", "--defined-only", binary],
+                            capture_output=True, text=True, check=True).stdout
+    sizes = {}
+    for line in output.splitlines():
+        fields = line.split()
+        if (len(fields) == 4 and fields[2] in "tTrRdD" and
+                re.search(pattern, fields[3])):
+            sizes[fields[3]] = sizes.get(fields[3], 0) + int(fields[1], 16)
+    return sizes
+
+
+def print_rows(title, ref, current):
+    print(f"{title:<32} {'ref':>8} {'current':>8} {'change':>8}")
+    for name in sorted(set(ref) | set(current), key=str.lower):
+        before = ref.get(name, 0)
+        after = current.get(name, 0)
+        change = f"{(after - before) / before * 100:+.0f}%" if before else ""
+        print(f"{name:<32} {before:>8} {after:>8} {change:>8}")
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit("usage: host_bench.py <keymap> <ref> [-s REGEX] [host args]")
+    keymap, ref = sys.argv[1:3]
+    args = sys.argv[3:]
+    pattern = None
+    if len(args) >= 2 and args[0] == "-s":
+        pattern = args[1]
+        args = args[2:]
+
+    ref_tree = os.path.join(BENCH_DIR, "ref")
+    shutil.rmtree(ref_tree, ignore_errors=True)
+    os.makedirs(ref_tree)
+    archive = subprocess.run(
+        ["git", "archive", ref, "host", "scripts", "keymaps/" + keymap],
+        cwd=ROOT, capture_output=True, check=True).stdout
+    subprocess.run(["tar", "-x", "-C", ref_tree], input=archive, check=True)
+
+    ref_binary = build(ref_tree, keymap)
+    current_binary = build(ROOT, keymap)
+
+    # Alternate between the builds and keep the fastest run of each, which
+    # filters out most of the noise from frequency scaling and other load.
+    ref_profile, ref_ns = best_of(ref_binary, args, {}, None)
+    current_profile, current_ns = best_of(current_binary, args, {}, None)
+    for _ in range(ROUNDS - 1):
+        ref_profile, ref_ns = best_of(ref_binary, args, ref_profile, ref_ns)
+        current_profile, current_ns = best_of(current_binary, args,
+                                              current_profile, current_ns)
+    print_rows("ns avg", ref_profile, current_profile)
+    print(f"{'ns/event':<32} {ref_ns:>8.1f} {current_ns:>8.1f}")
+
+    if pattern:
+        print()
+        ref_sizes = symbol_sizes(ref_binary, pattern)
+        current_sizes = symbol_sizes(current_binary, pattern)
+        print_rows("bytes", ref_sizes, current_sizes)
+        print(f"{'total':<32} {sum(ref_sizes.values()):>8} "
+              f"{sum(current_sizes.values()):>8}")
+
+
+if __name__ == "__main__":
+    main()
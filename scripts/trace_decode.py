@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+
+"""Decodes binary trace buffer records into readable logs.
+
+Reads console output (e.g. from `qmk console` or the host build with -v) on
+stdin, picks out the `~IIAATTTTBBBBCCCC` records written by
+features/trace_buffer.c and formats them with the strings declared in
+features/trace_events.h. Other console lines are passed through unchanged.
+
+Usage: qmk console | python3 scripts/trace_decode.py [keymap]
+"""
+
+import os
+import re
+import sys
+
+RECORD = re.compile(r"~([0-9A-F]{16})")
+EVENT = re.compile(r'^\s*TRACE_EVENT\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)', re.M)
+CHOICE = re.compile(r"\{(\w+)\|([^}]*)\}")
+
+
+def load_events(keymap):
+    path = os.path.join(os.path.dirname(__file__), "..", "keymaps", keymap,
+                        "features", "trace_events.h")
+    with open(path) as file:
+        return EVENT.findall(file.read())
+
+
+def format_record(events, fields):
+    event = int(fields[0:2], 16)
+    args = {
+        "a": int(fields[2:4], 16),
+        "b": int(fields[8:12], 16),
+        "c": int(fields[12:16], 16),
+    }
+    args["c_hi"] = args["c"] >> 8
+    args["c_lo"] = args["c"] & 0xFF
+    time = int(fields[4:8], 16)
+
+    if event >= len(events):
+        return "%5u  unknown event %u %s" % (time, event, fields)
+    name, fmt = events[event]
+
+    def choice(match):
+        names = match.group(2).split(",")
+        index = args[match.group(1)]
+        return names[index] if index < len(names) else str(index)
+
+    return "%5u  %-22s %s" % (time, name, CHOICE.sub(choice, fmt).format(**args))
+
+
+def main():
+    keymap = sys.argv[1] if len(sys.argv) > 1 else "palmdrop-core"
+    events = load_events(keymap)
+    for line in sys.stdin:
+        match = RECORD.search(line)
+        if match:
+            print(format_record(events, match.group(1)))
+        else:
+            sys.stdout.write(line)
+
+
+if __name__ == "__main__":
+    main()